@@ -1,7 +1,9 @@
 % compare spectra from jonswapSpec
+% (jonswap.bin comes from the jonswap demo, see jonswapLoad.m; run it as
+% "jonswap -t" to also get the old jonswap_*.txt dumps, and build it with
+% "make TRACE=1" to also log every bin bound, area and paddle amp)
  clf;
- dat = load('jonswap_spec.txt', '-ascii');
- dat0= load('jonswap_sample.txt','-ascii');
- plot(dat(:,1),dat(:,2))
+ d = jonswapLoad('jonswap.bin');
+ plot(d.w, d.S)
  hold on;
- plot(dat0(:,1),dat0(:,2),'+');
\ No newline at end of file
+ plot(d.wc, d.amps, '+');
@@ -0,0 +1,304 @@
+//
+//  jonswapBatch.cpp
+//
+//  Batch driver: runs a file of sea-state jobs in parallel and writes each
+//  job's bins as a jonswapIO file <outdir>/<name>.bin. Built on
+//  libjonswap by make lib.
+//
+//  One job per line as key=value pairs, '#' starts a comment:
+//
+//      name=tank1 alpha=0.05 wp=3.5 wmax=6 nbins=200 nmems=8 depth=0.4 seed=1
+//      name=storm vel10=15 F=2e4 nbins=500 depth=1.2 paddle=hinged hinge=0.6
+//
+//  The spectrum is alpha, wp, wmax and optionally gamma (3.3), s1 (0.07)
+//  and s2 (0.09), or vel10 and F for a fetch limited sea. depth is
+//  required; nbins (100), nmems (8), seed (0), paddle (flap, piston or
+//  hinged, default flap) and hinge are optional, and name defaults to
+//  job<line>; names must be unique within the file. Jobs run bin(nbins,
+//  seed), calcBinAmps(nmems) and calcPaddleAmps(depth), so a job's file
+//  depends only on its line.
+//
+//  usage: jonswap_batch [-o outdir] [-j threads] [-c cachedir] [-s npoints] jobs
+//         -o where the files go (.), -j worker threads (all), -c reuse
+//         bins through a jonswapCache, -s also write S(w) at npoints
+//         frequencies over (0, wmax]; jobs "-" reads stdin
+//
+//  Exits with 2 on a usage or job file error (nothing is run), 1 if any
+//  job failed, 0 otherwise.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "jonswapSpec.h"
+#include "jonswapIO.h"
+#include "jonswapCache.h"
+#include "jonswapPool.h"
+
+using std::vector;
+
+struct batchJob {
+	std::string name;
+	int line;
+	double alpha, wp, wmax, gamma, s1, s2;
+	double vel10, F;
+	int nbins, nmems;
+	double depth;
+	uint64_t seed;
+	jonswapPaddleModel paddle;
+
+	batchJob() : line(0), alpha(0), wp(0), wmax(0), gamma(3.3), s1(0.07), s2(0.09),
+		vel10(0), F(0), nbins(100), nmems(8), depth(0), seed(0) {}
+};
+
+struct batchOptions {
+	std::string outdir;
+	unsigned threads;
+	const jonswapCache *cache;
+	size_t npoints;
+
+	batchOptions() : outdir("."), threads(0), cache(NULL), npoints(0) {}
+};
+
+static bool parseDouble(const std::string &v, double &x) {
+	char *end;
+	errno = 0;
+	x = strtod(v.c_str(), &end);
+	return !v.empty() && !*end && !errno;
+}
+
+static bool parseInt(const std::string &v, long long &x) {
+	char *end;
+	errno = 0;
+	x = strtoll(v.c_str(), &end, 10);
+	return !v.empty() && !*end && !errno;
+}
+
+// One job line; false with the reason in err
+static bool parseJob(const std::string &text, int line, batchJob &j, std::string &err) {
+	j = batchJob();
+	j.line = line;
+	std::istringstream in(text);
+	std::string tok;
+	bool haveDepth = false;
+	while (in >> tok) {
+		size_t eq = tok.find('=');
+		if (eq == std::string::npos) {
+			err = "expected key=value, got " + tok;
+			return false;
+		}
+		std::string key = tok.substr(0, eq), val = tok.substr(eq + 1);
+		double *d = key == "alpha" ? &j.alpha : key == "wp" ? &j.wp : key == "wmax" ? &j.wmax
+			: key == "gamma" ? &j.gamma : key == "s1" ? &j.s1 : key == "s2" ? &j.s2
+			: key == "vel10" ? &j.vel10 : key == "F" ? &j.F : key == "depth" ? &j.depth
+			: key == "hinge" ? &j.paddle.hinge : NULL;
+		long long n;
+		if (d) {
+			if (!parseDouble(val, *d)) {
+				err = "bad number " + tok;
+				return false;
+			}
+			haveDepth |= d == &j.depth;
+		} else if (key == "nbins" || key == "nmems") {
+			if (!parseInt(val, n) || n < 1 || n > (1 << 30)) {
+				err = "bad count " + tok;
+				return false;
+			}
+			(key == "nbins" ? j.nbins : j.nmems) = (int) n;
+		} else if (key == "seed") {
+			if (!parseInt(val, n)) {
+				err = "bad seed " + tok;
+				return false;
+			}
+			j.seed = (uint64_t) n;
+		} else if (key == "paddle") {
+			int t;
+			for (t = 0; t < JONSWAP_PADDLE_TYPES; t++)
+				if (val == jonswapPaddleName((jonswapPaddleType) t))
+					break;
+			if (t == JONSWAP_PADDLE_TYPES) {
+				err = "unknown paddle " + val;
+				return false;
+			}
+			j.paddle.type = (jonswapPaddleType) t;
+		} else if (key == "name") {
+			if (val.empty() || val.find('/') != std::string::npos) {
+				err = "bad name " + tok;
+				return false;
+			}
+			j.name = val;
+		} else {
+			err = "unknown key " + key;
+			return false;
+		}
+	}
+
+	bool wind = j.vel10 > 0 || j.F > 0;
+	if (wind ? !(j.vel10 > 0 && j.F > 0) : !(j.alpha > 0 && j.wp > 0 && j.wmax > 0)) {
+		err = "needs alpha, wp and wmax, or vel10 and F";
+		return false;
+	}
+	if (!haveDepth || !(j.depth > 0)) {
+		err = "needs depth > 0";
+		return false;
+	}
+	if (j.paddle.type == JONSWAP_PADDLE_HINGED && !(j.paddle.hinge > 0)) {
+		err = "hinged paddle needs hinge > 0";
+		return false;
+	}
+	if (j.name.empty()) {
+		char buf[32];
+		snprintf(buf, sizeof(buf), "job%d", line);
+		j.name = buf;
+	}
+	return true;
+}
+
+// Every job of in; false after reporting the first bad line. Names must
+// be unique, two jobs would write the same file.
+static bool readJobs(std::istream &in, const char *file, vector<batchJob> &jobs) {
+	std::string text;
+	std::map<std::string, int> names;
+	for (int line = 1; std::getline(in, text); line++) {
+		size_t hash = text.find('#');
+		if (hash != std::string::npos)
+			text.erase(hash);
+		if (text.find_first_not_of(" \t\r") == std::string::npos)
+			continue;
+		batchJob j;
+		std::string err;
+		if (!parseJob(text, line, j, err)) {
+			fprintf(stderr, "%s:%d: %s\n", file, line, err.c_str());
+			return false;
+		}
+		std::pair<std::map<std::string, int>::iterator, bool> seen =
+			names.insert(std::make_pair(j.name, line));
+		if (!seen.second) {
+			fprintf(stderr, "%s:%d: name %s already used on line %d\n", file, line,
+				j.name.c_str(), seen.first->second);
+			return false;
+		}
+		jobs.push_back(j);
+	}
+	return true;
+}
+
+static bool runJob(const batchJob &j, const batchOptions &o, std::string &err) {
+	jonswapSpec spec = j.vel10 > 0 ? jonswapSpec(j.vel10, j.F)
+		: jonswapSpec(j.alpha, j.wp, j.wmax, j.gamma, j.s1, j.s2);
+	spec.setPaddleModel(j.paddle);
+
+	vector<double> w(o.npoints), S(o.npoints);
+	for (size_t i = 0; i < o.npoints; i++)
+		w[i] = (i + 1) * spec.getWmax() / o.npoints;
+	if (o.npoints)
+		spec.getamp(&w[0], &S[0], o.npoints);
+
+	std::string path = o.outdir + "/" + j.name + ".bin";
+	bool ok;
+	if (o.cache) {
+		// the cached arrays go out straight from the mapping
+		jonswapMappedFile f;
+		if (!o.cache->get(spec, j.nbins, j.nmems, j.depth, j.seed, f)) {
+			err = "cache failed";
+			return false;
+		}
+		jonswapFileHeader h = f.header();
+		h.count[JONSWAP_IO_W] = w.size();
+		h.count[JONSWAP_IO_S] = S.size();
+		const double *arrays[JONSWAP_IO_ARRAYS] = {
+			w.empty() ? NULL : &w[0],
+			S.empty() ? NULL : &S[0],
+			f.array(JONSWAP_IO_EDGES),
+			f.array(JONSWAP_IO_WC),
+			f.array(JONSWAP_IO_AMPS),
+			f.array(JONSWAP_IO_PADDLE)
+		};
+		ok = jonswapWriteFile(path.c_str(), h, arrays);
+	} else {
+		spec.bin(j.nbins, j.seed);
+		spec.calcBinAmps(j.nmems);
+		spec.calcPaddleAmps(j.depth);
+		ok = jonswapWriteFile(path.c_str(), spec, w, S, j.depth);
+	}
+	if (!ok)
+		err = "can't write " + path;
+	return ok;
+}
+
+static int usage() {
+	fprintf(stderr, "usage: jonswap_batch [-o outdir] [-j threads] [-c cachedir] [-s npoints] jobs\n");
+	return 2;
+}
+
+int main(int argc, char *argv[]) {
+	batchOptions o;
+	const char *file = NULL;
+	std::unique_ptr<jonswapCache> cache;
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-o") && i + 1 < argc)
+			o.outdir = argv[++i];
+		else if (!strcmp(argv[i], "-j") && i + 1 < argc)
+			o.threads = (unsigned) atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-c") && i + 1 < argc)
+			cache.reset(new jonswapCache(argv[++i]));
+		else if (!strcmp(argv[i], "-s") && i + 1 < argc)
+			o.npoints = (size_t) atol(argv[++i]);
+		else if (!file && (argv[i][0] != '-' || !strcmp(argv[i], "-")))
+			file = argv[i];
+		else
+			return usage();
+	}
+	if (!file)
+		return usage();
+	o.cache = cache.get();
+
+	vector<batchJob> jobs;
+	if (!strcmp(file, "-")) {
+		if (!readJobs(std::cin, "stdin", jobs))
+			return 2;
+	} else {
+		std::ifstream in(file);
+		if (!in) {
+			fprintf(stderr, "jonswap_batch: can't read %s\n", file);
+			return 2;
+		}
+		if (!readJobs(in, file, jobs))
+			return 2;
+	}
+	if (mkdir(o.outdir.c_str(), 0777) != 0 && errno != EEXIST) {
+		fprintf(stderr, "jonswap_batch: can't create %s\n", o.outdir.c_str());
+		return 2;
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	vector<char> ok(jobs.size());
+	vector<std::string> errs(jobs.size());
+	jonswapPool pool(o.threads);
+	pool.parallelFor(jobs.size(), 1, [&](size_t begin, size_t end, unsigned) {
+		for (size_t i = begin; i < end; i++)
+			ok[i] = runJob(jobs[i], o, errs[i]);
+	});
+	double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	size_t failed = 0;
+	for (size_t i = 0; i < jobs.size(); i++) {
+		if (!ok[i]) {
+			fprintf(stderr, "%s:%d: %s: %s\n", file, jobs[i].line, jobs[i].name.c_str(), errs[i].c_str());
+			failed++;
+		}
+	}
+	printf("%zu jobs, %zu failed, %u threads, %.3g s\n", jobs.size(), failed, pool.size(), secs);
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,486 @@
+//
+//  jonswapBench.cpp
+//
+//  Benchmarks of the spectrum: scalar getamp against the batch kernels,
+//  binning, bin integration, paddle strokes, the sea-state sweep and the
+//  synthesizers. Use makefile to create the executable: make bench
+//
+//  usage: jonswap_bench [-j results.json] [-r reps] [-w warmup] [npoints]
+//
+
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <thread>
+#include <vector>
+#include "jonswapSpec.h"
+#include "jonswapEval.h"
+#include "jonswapFixed.h"
+#include "jonswapQuad.h"
+#include "jonswapCDF.h"
+#include "jonswapSweep.h"
+#include "jonswapSynth.h"
+#include "jonswapFFTSynth.h"
+#include "jonswapPipeline.h"
+#include "jonswapDirSpec.h"
+#include "jonswapCache.h"
+#include "jonswapMoments.h"
+#include "jonswapSolve.h"
+#include "jonswapMultiSpec.h"
+#include "jonswapLive.h"
+#include "jonswapBenchmark.h"
+
+static double maxAbsErr(const vector<double> &a, const vector<double> &b) {
+	double e = 0;
+	for (size_t i = 0; i < a.size() && i < b.size(); i++)
+		e = fmax(e, fabs(a[i] - b[i]));
+	return e;
+}
+
+int main(int argc, char *argv[]) {
+	size_t npoints = 1000000;
+	const char *json = NULL;
+	int reps = 21, warmup = 2;
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-j") && i + 1 < argc)
+			json = argv[++i];
+		else if (!strcmp(argv[i], "-r") && i + 1 < argc)
+			reps = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-w") && i + 1 < argc)
+			warmup = atoi(argv[++i]);
+		else
+			npoints = atol(argv[i]);
+	}
+
+	jonswapBenchmark bench(warmup, reps);
+	jonswapPool pool;
+	char threads[16];
+	snprintf(threads, sizeof(threads), "%u", pool.size());
+	bench.context("kernel", jonswapKernelName(jonswapGetKernel()));
+	bench.context("threads", threads);
+
+	double max_freq = 6.0;
+	jonswapSpec jonswap = jonswapSpec(.05, 3.5, max_freq);
+
+	vector<double> w(npoints);
+	vector<double> ref(npoints);
+	vector<double> out(npoints);
+	for (size_t i = 0; i < npoints; i++)
+		w[i] = (i + 1) * max_freq / npoints;
+
+	// getamp: scalar against the batch kernels
+	double t = bench.run("getamp", npoints, "points", [&]() {
+		for (size_t i = 0; i < npoints; i++)
+			ref[i] = jonswap.getamp(w[i]);
+	}).median();
+
+	const jonswapEval eval(jonswap);
+	bench.run("eval", npoints, "points", [&]() {
+		for (size_t i = 0; i < npoints; i++)
+			out[i] = eval(w[i]);
+	});
+	bench.note("speedup", t / bench.find("eval")->median());
+
+	const jonswapDefault fixed(.05, 3.5);
+	bench.run("fixed", npoints, "points", [&]() {
+		for (size_t i = 0; i < npoints; i++)
+			out[i] = fixed(w[i]);
+	});
+	bench.note("speedup", t / bench.find("fixed")->median());
+
+	const jonswapPM pm(.05, 3.5);
+	bench.run("fixedPM", npoints, "points", [&]() {
+		for (size_t i = 0; i < npoints; i++)
+			out[i] = pm(w[i]);
+	});
+	bench.note("speedup", t / bench.find("fixedPM")->median());
+
+	vector<float> wf(w.begin(), w.end()), outf(npoints);
+	const jonswapKernelType kernels[] = {
+		JONSWAP_KERNEL_SCALAR, JONSWAP_KERNEL_AVX2, JONSWAP_KERNEL_AVX512, JONSWAP_KERNEL_NEON
+	};
+	for (size_t k = 0; k < sizeof(kernels)/sizeof(kernels[0]); k++) {
+		if (!jonswapSetKernel(kernels[k]))
+			continue;
+
+		std::string name = std::string("batch_") + jonswapKernelName(kernels[k]);
+		double tk = bench.run(name, npoints, "points", [&]() {
+			jonswap.getamp(&w[0], &out[0], npoints);
+		}).median();
+
+		double maxRel = 0;
+		for (size_t i = 0; i < npoints; i++) {
+			if (ref[i] > 1e-300) {
+				double rel = fabs(out[i] - ref[i]) / ref[i];
+				if (rel > maxRel)
+					maxRel = rel;
+			}
+		}
+		bench.note("speedup", t / tk);
+		bench.note("max_rel_err", maxRel);
+
+		name = std::string("batchf_") + jonswapKernelName(kernels[k]);
+		bench.run(name, npoints, "points", [&]() {
+			jonswap.getamp(&wf[0], &outf[0], npoints);
+		});
+		bench.note("speedup_over_double", tk / bench.find(name)->median());
+	}
+	jonswapSetKernel(JONSWAP_KERNEL_AUTO);
+
+	// binning
+	const int binCounts[] = { 10, 1000, 100000 };
+	for (size_t k = 0; k < sizeof(binCounts)/sizeof(binCounts[0]); k++) {
+		char name[32];
+		snprintf(name, sizeof(name), "bin_%d", binCounts[k]);
+		uint64_t seed = 1;
+		bench.run(name, binCounts[k], "bins", [&]() { jonswap.bin(binCounts[k], seed++); });
+	}
+
+	// rejection sampled normal edges against the O(n) generators
+	{
+		const int n = 100000;
+		jonswapPipeline p(jonswap, 1);
+		jonswapBins bins;
+		p.setBinMode(JONSWAP_BINS_NORMAL);
+		bench.run("bin_normal_100000", n, "bins", [&]() { p.bin(n, bins); });
+		jonswapEdgeOptions o(JONSWAP_SPACING_NORMAL);
+		o.mu = jonswap.getWp();
+		o.sigma = o.mu / 2;
+		p.setEdgeOptions(o);
+		bench.run("edges_normal_100000", n, "bins", [&]() { p.bin(n, bins); });
+		p.setEdgeOptions(jonswapEdgeOptions(JONSWAP_SPACING_ENERGY, JONSWAP_SAMPLING_HALTON));
+		bench.run("edges_energy_100000", n, "bins", [&]() { p.bin(n, bins); });
+	}
+
+	// components needed for the Gaussianity (effective component count) of
+	// 1000 uniform bins, with error bounded energy bins of at most 10 uniform
+	// widths
+	{
+		const int n = 1000;
+		const double maxWidths = 10;
+		jonswapCDF cdf(jonswap);
+		double wmax = jonswap.getWmax();
+		vector<double> ue(n + 1), ua(n);
+		for (int i = 0; i <= n; i++)
+			ue[i] = i * wmax / n;
+		cdf.binEnergies(&ue[0], n, &ua[0]);
+		double neff = jonswapEffectiveComponents(&ua[0], n);
+
+		vector<double> ee;
+		bench.run("energyEdges", 1, "grids", [&]() {
+			jonswapEnergyEdges(cdf, 1 / neff, maxWidths * wmax / n, ee);
+		});
+		size_t ne = ee.size() - 1;
+		vector<double> ea(ne);
+		cdf.binEnergies(&ee[0], ne, &ea[0]);
+		bench.note("uniform_bins", n);
+		bench.note("uniform_neff", neff);
+		bench.note("energy_bins", ne);
+		bench.note("energy_neff", jonswapEffectiveComponents(&ea[0], ne));
+		bench.note("bin_reduction", (double) n / ne);
+	}
+
+	// calcBinAmps over nmems on 1000 bins, against a tight adaptive reference
+	size_t nbins = 1000;
+	vector<double> edges(nbins + 1), area(nbins), refArea(nbins);
+	for (size_t i = 0; i <= nbins; i++)
+		edges[i] = i * max_freq / nbins;
+
+	jonswapQuad quad;
+	quad.integrateAdaptive(eval, &edges[0], nbins, &refArea[0], 1e-13);
+
+	jonswap.bin(nbins, 1);
+	const int nmems[] = { 1, 2, 4, 8, 20 };
+	for (size_t k = 0; k < sizeof(nmems)/sizeof(nmems[0]); k++) {
+		char name[32];
+		snprintf(name, sizeof(name), "calcBinAmps_%d", nmems[k]);
+		bench.run(name, nbins, "bins", [&]() { jonswap.calcBinAmps(nmems[k]); });
+
+		quad.setOrder(nmems[k]);
+		quad.integrate(eval, &edges[0], nbins, &area[0]);
+		bench.note("evals", quad.evaluations());
+		bench.note("max_abs_err", maxAbsErr(area, refArea));
+	}
+
+	const double tols[] = { 1e-6, 1e-10 };
+	for (size_t k = 0; k < sizeof(tols)/sizeof(tols[0]); k++) {
+		char name[32];
+		snprintf(name, sizeof(name), "gk15_%.0e", tols[k]);
+		bench.run(name, nbins, "bins", [&]() {
+			quad.integrateAdaptive(eval, &edges[0], nbins, &area[0], tols[k]);
+		});
+		bench.note("evals", quad.evaluations());
+		bench.note("max_abs_err", maxAbsErr(area, refArea));
+	}
+
+	bench.run("cdf_build", 1, "tables", [&]() { jonswapCDF build(eval, max_freq); });
+	jonswapCDF cdf(eval, max_freq);
+	bench.run("cdf", nbins, "bins", [&]() { cdf.binEnergies(&edges[0], nbins, &area[0]); });
+	bench.note("max_abs_err", maxAbsErr(area, refArea));
+
+	// moments and statistics: fused bin pass against one loop per figure,
+	// and the continuous spectrum
+	{
+		jonswap.calcBinAmps(8);
+		const jonswapBins &b = jonswap.getBinData();
+		jonswapStats st;
+		double tLoops = bench.run("moments_loops", nbins, "bins", [&]() {
+			double m[5];
+			for (int k = 0; k < 5; k++) {
+				m[k] = 0;
+				for (size_t i = 0; i < b.size(); i++)
+					m[k] += b.amps[i] * b.width[i] * pow(b.wc[i], k);
+			}
+			st = jonswapStatsFromMoments(m, 0);
+		}).median();
+		double tFused = bench.run("moments_bins", nbins, "bins", [&]() {
+			st = jonswapBinMoments(b);
+		}).median();
+		bench.note("speedup", tLoops / tFused);
+		bench.run("moments_spectrum", 1, "spectra", [&]() { st = jonswap.moments(); });
+	}
+
+	// (Hs, Tp, gamma) -> constructor parameters for a scenario library
+	{
+		jonswapParamSolver solver;
+		size_t n = 10000;
+		vector<jonswapSeaState> states(n);
+		vector<jonswapSpecParams> params(n);
+		for (size_t i = 0; i < n; i++) {
+			states[i].Hs = 0.05 + 0.3 * i / n;
+			states[i].Tp = 0.8 + 2.0 * i / n;
+			states[i].gamma = 1 + 9.0 * ((i * 7919) % n) / n;
+		}
+		bench.run("solve_table", 1, "tables", [&]() { jonswapParamSolver build; });
+		bench.run("solve", n, "states", [&]() { solver.solve(&states[0], n, &params[0]); });
+		double maxErr = 0;
+		for (size_t i = 0; i < n; i += n / 50) {
+			double Hs = params[i].make().moments().Hs;
+			maxErr = fmax(maxErr, fabs(Hs - states[i].Hs) / states[i].Hs);
+		}
+		bench.note("max_rel_err_Hs", maxErr);
+	}
+
+	// wind sea + swell: one fused pass over both peaks against one batch
+	// pass per peak and a sum
+	{
+		jonswapSpec swell(.002, 1.2, max_freq, 7.0);
+		jonswapMultiSpec sea(jonswap);
+		sea.addPeak(.002, 1.2, 7.0);
+		vector<double> part(npoints);
+		double tTwo = bench.run("peaks2_separate", npoints, "points", [&]() {
+			jonswap.getamp(&w[0], &ref[0], npoints);
+			swell.getamp(&w[0], &part[0], npoints);
+			for (size_t i = 0; i < npoints; i++)
+				ref[i] += part[i];
+		}).median();
+		double tFused = bench.run("peaks2_fused", npoints, "points", [&]() {
+			sea.getamp(&w[0], &out[0], npoints);
+		}).median();
+		double maxRel = 0;
+		for (size_t i = 0; i < npoints; i++)
+			if (ref[i] > 1e-300)
+				maxRel = fmax(maxRel, fabs(out[i] - ref[i]) / ref[i]);
+		bench.note("speedup", tTwo / tFused);
+		bench.note("max_rel_err", maxRel);
+
+		double m0 = jonswap.moments().m0 + swell.moments().m0;
+		jonswapStats st;
+		bench.run("peaks2_moments", 1, "spectra", [&]() { st = sea.moments(); });
+		bench.note("m0_rel_err", fabs(st.m0 - m0) / m0);
+	}
+
+	// paddle strokes: solving every bin against the per-depth H/S cache
+	jonswap.calcBinAmps(8);
+	jonswapBins paddleBins = jonswap.getBinData();
+	bench.run("paddleAmps", nbins, "bins", [&]() { jonswapPaddleAmps(paddleBins, 0.4); });
+	bench.run("calcPaddleAmps_cached", nbins, "bins", [&]() { jonswap.calcPaddleAmps(0.4); });
+
+	// 64 paddles, 1000 frequency bins, 36 directions: one cos/sin per cell
+	// and paddle against the tiled phasor recurrence
+	{
+		jonswapDirSpec dir(jonswap, JONSWAP_SPREAD_COS2S, 10);
+		dir.binDirections(36);
+		jonswapPaddleArray paddles(64, 0.5);
+		dir.calcArrayAmps(paddles, 1, &pool);
+		const jonswapBins &b = dir.getBinData();
+		size_t nf = b.size(), nd = dir.getThetas().size();
+		size_t cells = paddles.count * nf * nd;
+		vector<double> k(nf), amp(paddles.count * nf);
+		jonswapDispersion(&b.wc[0], nf, 0.4, &k[0], 3);
+		for (size_t i = 0; i < nf; i++)
+			k[i] /= 0.4;
+
+		double tNaive = bench.run("dirArray_naive", cells, "cells", [&]() {
+			const vector<double> &phi = dir.getCellPhases();
+			for (size_t p = 0; p < paddles.count; p++) {
+				double y = paddles.y0 + p * paddles.spacing;
+				for (size_t i = 0; i < nf; i++) {
+					double re = 0, im = 0;
+					for (size_t j = 0; j < nd; j++) {
+						double d = sqrt(dir.getDirWeights()[j]);
+						double ph = phi[i * nd + j] - k[i] * y * sin(dir.getThetas()[j]);
+						re += d * cos(ph);
+						im += d * sin(ph);
+					}
+					amp[p * nf + i] = b.paddleAmps[i] * sqrt(re * re + im * im);
+				}
+			}
+		}).median();
+		double tArray = bench.run("dirArray", cells, "cells", [&]() {
+			dir.calcArrayAmps(paddles, 1, &pool);
+		}).median();
+		double maxErr = 0;
+		for (size_t c = 0; c < amp.size(); c++)
+			maxErr = fmax(maxErr, fabs(amp[c] - dir.getArrayAmps()[c]) / b.paddleAmps[c % nf]);
+		bench.note("speedup", tNaive / tArray);
+		bench.note("max_rel_err", maxErr);
+	}
+
+	// controller startup: the whole pipeline against mapping a cache entry
+	{
+		const char *tmp = getenv("TMPDIR");
+		jonswapCache cache(std::string(tmp ? tmp : "/tmp") + "/jonswap_bench_cache");
+		jonswapSpec cold(.05, 3.5, max_freq);
+		jonswapMappedFile f;
+		bench.run("startup_pipeline", 1, "configs", [&]() {
+			cold.bin((int) nbins, 7);
+			cold.calcBinAmps(20);
+			cold.calcPaddleAmps(0.4);
+		});
+		jonswapCacheKey key(cold, (int) nbins, 20, 0.4, 7);
+		if (cache.store(key, cold))
+			bench.run("startup_cache_hit", 1, "configs", [&]() { cache.load(key, f); });
+		unlink(cache.path(key).c_str());
+	}
+
+	// (U10, F) sweep: one object per sea state against one batched pass
+	size_t nstates = 2000, nfreq = 1000;
+	vector<double> vel10(nstates), fetch(nstates), grid(nfreq), matrix(nstates * nfreq);
+	for (size_t i = 0; i < nstates; i++) {
+		vel10[i] = 5 + 20.0 * i / nstates;
+		fetch[i] = 1e4 + 1e5 * ((i * 7) % nstates) / nstates;
+	}
+	for (size_t j = 0; j < nfreq; j++)
+		grid[j] = (j + 1) * 3.0 / nfreq;
+
+	double tObj = bench.run("sweep_objects", nstates, "states", [&]() {
+		for (size_t i = 0; i < nstates; i++) {
+			jonswapSpec state(vel10[i], fetch[i]);
+			vector<double> row = state.getamp(grid);
+			matrix[i * nfreq] = row[0];
+		}
+	}).median();
+	double tSweep = bench.run("sweep", nstates, "states", [&]() {
+		jonswapSweepWind(pool, nstates, &vel10[0], &fetch[0], &grid[0], nfreq, &matrix[0]);
+	}).median();
+	bench.note("speedup", tObj / tSweep);
+
+	vector<float> gridf(grid.begin(), grid.end()), matrixf(nstates * nfreq);
+	double tSweepF = bench.run("sweep_float", nstates, "states", [&]() {
+		jonswapSweepWind(pool, nstates, &vel10[0], &fetch[0], &gridf[0], nfreq, &matrixf[0]);
+	}).median();
+	double peakS = 0, maxAbs = 0;
+	for (size_t i = 0; i < matrix.size(); i++) {
+		peakS = fmax(peakS, matrix[i]);
+		maxAbs = fmax(maxAbs, fabs(matrixf[i] - matrix[i]));
+	}
+	bench.note("speedup", tSweep / tSweepF);
+	bench.note("max_err_over_peak", maxAbs / peakS);
+
+	// paddle signal: phasor synthesis against a cos per component per sample
+	jonswap.bin(300, 1);
+	jonswap.calcBinAmps(8);
+	jonswap.calcPaddleAmps(0.4);
+	const jonswapBins &sb = jonswap.getBinData();
+	size_t nsamples = 100000;
+	vector<double> signal(nsamples);
+	jonswapSynth synth(1000.0);
+	synth.setComponents(sb, 1);
+	double tNaive = bench.run("synth_naive", nsamples, "samples", [&]() {
+		for (size_t j = 0; j < nsamples; j++) {
+			double tj = j / synth.rate(), x = 0;
+			for (size_t i = 0; i < sb.size(); i++)
+				x += sb.paddleAmps[i] * cos(sb.wc[i] * tj + synth.phases()[i]);
+			signal[j] = x;
+		}
+	}).median();
+	double tSynth = bench.run("synth", nsamples, "samples", [&]() {
+		synth.reset();
+		synth.generate(&signal[0], nsamples);
+	}).median();
+	bench.note("speedup", tNaive / tSynth);
+	bench.note("components", sb.size());
+
+	vector<float> signalf(nsamples);
+	jonswapSynthF synthf(1000.0);
+	synthf.setComponents(sb, 1);
+	double tSynthF = bench.run("synth_float", nsamples, "samples", [&]() {
+		synthf.reset();
+		synthf.generate(&signalf[0], nsamples);
+	}).median();
+	synth.reset();
+	synth.generate(&signal[0], nsamples);
+	double peakX = 0, maxDev = 0;
+	for (size_t j = 0; j < nsamples; j++) {
+		peakX = fmax(peakX, fabs(signal[j]));
+		maxDev = fmax(maxDev, fabs(signalf[j] - signal[j]));
+	}
+	bench.note("speedup", tSynth / tSynthF);
+	bench.note("max_err_over_peak", maxDev / peakX);
+
+	// IFFT realization on a 2^16 grid, and where it overtakes the direct sum
+	jonswapFFTSynth fsynth(synth.rate(), 1 << 16);
+	fsynth.setSpectrum(eval, 1);
+	double tFFT = bench.run("fftsynth", nsamples, "samples", [&]() {
+		fsynth.generate(&signal[0], nsamples);
+	}).median();
+	bench.note("speedup", tSynth / tFFT);
+	bench.note("crossover_components", jonswapSynthCrossover(synth.rate(), fsynth.size()));
+
+	// live sea state changes: what a rebuild costs the thread doing it,
+	// against one 64 sample chunk on the real-time thread, steady and while
+	// a background thread keeps publishing (cpu time of the real-time
+	// thread only, so the publisher sharing the core does not count)
+	{
+		jonswapLive live(synth.rate(), 64);
+		vector<double> chunk(live.chunkSize());
+		bench.run("live_prepare", 1, "configs", [&]() {
+			live.prepare(jonswap, 300, 8, 0.4, 1);
+		});
+		live.publish(live.prepare(jonswap, 300, 8, 0.4, 1));
+		bench.run("live_chunk", live.chunkSize(), "samples", [&]() {
+			live.generate(&chunk[0], chunk.size());
+		});
+
+		std::atomic<bool> stop(false);
+		std::thread control([&]() {
+			for (uint64_t s = 2; !stop.load(); s++) {
+				jonswapSpec next(.05, 3.0 + 0.5 * (s % 3), max_freq);
+				live.publish(live.prepare(next, 300, 8, 0.4, s));
+				std::this_thread::sleep_for(std::chrono::microseconds(500));
+			}
+		});
+		uint64_t swaps0 = live.swaps();
+		double worst = 0;
+		for (int i = 0; i < 20000; i++) {
+			timespec a, b;
+			clock_gettime(CLOCK_THREAD_CPUTIME_ID, &a);
+			live.generate(&chunk[0], chunk.size());
+			clock_gettime(CLOCK_THREAD_CPUTIME_ID, &b);
+			worst = fmax(worst, (b.tv_sec - a.tv_sec) + 1e-9 * (b.tv_nsec - a.tv_nsec));
+		}
+		stop = true;
+		control.join();
+		bench.note("swaps", live.swaps() - swaps0);
+		bench.note("worst_chunk_cpu_s", worst);
+		bench.note("deadline_s", live.chunkSize() / live.rate());
+	}
+
+	if (json && !bench.writeJson(json)) {
+		fprintf(stderr, "jonswap_bench: can't write %s\n", json);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,171 @@
+//
+//  jonswapBenchmark.h
+//
+//  Microbenchmark harness for jonswap_bench. Every case is warmed up,
+//  calibrated so one sample lasts at least minSample seconds, and then
+//  timed over a number of repetitions. The median and the 99th percentile
+//  of the seconds per call are reported, along with any extra figures the
+//  case attaches (errors, evaluation counts, speedups). The results can
+//  be written as JSON to track regressions.
+//
+
+#ifndef JONSWAPBENCHMARK_H
+#define JONSWAPBENCHMARK_H
+
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+using std::vector;
+
+struct jonswapBenchResult {
+	std::string name;
+	std::string unit;      // what items counts: points, bins, samples, ...
+	double items;          // items per call
+	size_t inner;          // calls per timed sample
+	vector<double> secs;   // seconds per call, sorted
+	vector<std::pair<std::string, double> > extra;
+
+	double median() const { return quantile(0.5); }
+	double p99() const { return quantile(0.99); }
+	double rate() const { return items / median(); }
+
+	// nearest rank
+	double quantile(double q) const {
+		if (secs.empty())
+			return 0;
+		size_t k = (size_t) ceil(q * secs.size());
+		return secs[k > 0 ? k - 1 : 0];
+	}
+};
+
+class jonswapBenchmark
+{
+public:
+	typedef std::chrono::steady_clock clock;
+
+	jonswapBenchmark(int warmup = 2, int reps = 21, double minSample = 2e-3)
+		: warmup(warmup), reps(reps < 1 ? 1 : reps), minSample(minSample) {}
+
+	// Time f, which processes items units per call
+	template<class F> jonswapBenchResult &run(const std::string &name, double items,
+			const std::string &unit, F f) {
+		size_t inner = 1;
+		for (int i = 0; i < warmup || i == 0; i++) {
+			double t = timeCalls(f, inner);
+			while (t < minSample && inner < ((size_t) 1 << 30)) {
+				inner *= t > 0 ? std::max<size_t>(2, (size_t) ceil(minSample / t)) : 2;
+				t = timeCalls(f, inner);
+			}
+		}
+
+		jonswapBenchResult r;
+		r.name = name;
+		r.unit = unit;
+		r.items = items;
+		r.inner = inner;
+		for (int i = 0; i < reps; i++)
+			r.secs.push_back(timeCalls(f, inner) / inner);
+		std::sort(r.secs.begin(), r.secs.end());
+
+		printf("%-22s %12.4g %s/s  p99 %10.4g s\n", name.c_str(), r.rate(), unit.c_str(), r.p99());
+		results.push_back(r);
+		return results.back();
+	}
+
+	// Attach an extra figure to the last result
+	void note(const std::string &key, double value) {
+		if (results.empty())
+			return;
+		results.back().extra.push_back(std::make_pair(key, value));
+		printf("%-22s   %s %.4g\n", "", key.c_str(), value);
+	}
+
+	// Context for the whole run (kernel, threads, ...)
+	void context(const std::string &key, const std::string &value) {
+		info.push_back(std::make_pair(key, value));
+	}
+
+	const jonswapBenchResult *find(const std::string &name) const {
+		for (size_t i = 0; i < results.size(); i++)
+			if (results[i].name == name)
+				return &results[i];
+		return NULL;
+	}
+
+	bool writeJson(const char *path) const {
+		FILE *f = fopen(path, "w");
+		if (!f)
+			return false;
+		fprintf(f, "{\n  \"warmup\": %d,\n  \"repetitions\": %d,\n", warmup, reps);
+		for (size_t i = 0; i < info.size(); i++) {
+			fputs("  ", f);
+			putString(f, info[i].first);
+			fputs(": ", f);
+			putString(f, info[i].second);
+			fputs(",\n", f);
+		}
+		fprintf(f, "  \"results\": [\n");
+		for (size_t i = 0; i < results.size(); i++) {
+			const jonswapBenchResult &r = results[i];
+			fputs("    {\"name\": ", f);
+			putString(f, r.name);
+			fputs(", \"unit\": ", f);
+			putString(f, r.unit);
+			fprintf(f, ", \"items\": %.17g, \"inner\": %zu", r.items, r.inner);
+			putNumber(f, "median_s", r.median());
+			putNumber(f, "p99_s", r.p99());
+			putNumber(f, "min_s", r.secs.front());
+			putNumber(f, "rate", r.rate());
+			for (size_t k = 0; k < r.extra.size(); k++)
+				putNumber(f, r.extra[k].first, r.extra[k].second);
+			fprintf(f, "}%s\n", i + 1 < results.size() ? "," : "");
+		}
+		fprintf(f, "  ]\n}\n");
+		return fclose(f) == 0;
+	}
+
+private:
+	int warmup, reps;
+	double minSample;
+	vector<jonswapBenchResult> results;
+	vector<std::pair<std::string, std::string> > info;
+
+	// s as a JSON string: quotes, backslashes and control characters escaped
+	static void putString(FILE *f, const std::string &s) {
+		fputc('"', f);
+		for (size_t i = 0; i < s.size(); i++) {
+			unsigned char c = s[i];
+			if (c == '"' || c == '\\')
+				fprintf(f, "\\%c", c);
+			else if (c < 0x20)
+				fprintf(f, "\\u%04x", c);
+			else
+				fputc(c, f);
+		}
+		fputc('"', f);
+	}
+
+	// , "key": x with null for what JSON has no number for (inf, nan)
+	static void putNumber(FILE *f, const std::string &key, double x) {
+		fputs(", ", f);
+		putString(f, key);
+		if (isfinite(x))
+			fprintf(f, ": %.6e", x);
+		else
+			fputs(": null", f);
+	}
+
+	template<class F> static double timeCalls(F &f, size_t n) {
+		clock::time_point start = clock::now();
+		for (size_t i = 0; i < n; i++)
+			f();
+		return std::chrono::duration<double>(clock::now() - start).count();
+	}
+};
+
+#endif
@@ -0,0 +1,54 @@
+//
+//  jonswapBins.h
+//
+//  Frequency bins of a spectrum as parallel arrays (structure of arrays).
+//  edges holds size()+1 sorted values, 0 and wmax included; bin i spans
+//  [edges[i], edges[i+1]] with center wc[i] and width width[i].
+//
+
+#ifndef JONSWAPBINS_H
+#define JONSWAPBINS_H
+
+#include <stddef.h>
+#include <vector>
+
+using std::vector;
+
+struct jonswapBins {
+	vector<double> edges;
+	vector<double> wc;
+	vector<double> width;
+	vector<double> amps;
+	vector<double> paddleAmps;
+
+	size_t size() const { return wc.size(); }
+
+	// Fill wc and width from edges
+	void setCenters() {
+		size_t n = edges.size() > 0 ? edges.size() - 1 : 0;
+		wc.resize(n);
+		width.resize(n);
+		for (size_t i = 0; i < n; i++) {
+			wc[i] = (edges[i] + edges[i + 1]) / 2;
+			width[i] = edges[i + 1] - edges[i];
+		}
+	}
+
+	void reserve(size_t n) {
+		edges.reserve(n + 1);
+		wc.reserve(n);
+		width.reserve(n);
+		amps.reserve(n);
+		paddleAmps.reserve(n);
+	}
+
+	void clear() {
+		edges.clear();
+		wc.clear();
+		width.clear();
+		amps.clear();
+		paddleAmps.clear();
+	}
+};
+
+#endif
@@ -0,0 +1,144 @@
+//
+//  jonswapCDF.cpp
+//
+
+#include <math.h>
+#include <algorithm>
+#include "jonswapCDF.h"
+#include "jonswapQuad.h"
+#include "jonswapProfile.h"
+
+jonswapCDF::jonswapCDF(const jonswapSpec &spec, size_t ncells) : wmax(spec.getWmax()) {
+	build(jonswapEval(spec), ncells);
+}
+
+jonswapCDF::jonswapCDF(const jonswapEval &S, double wmax, size_t ncells) : wmax(wmax) {
+	build(S, ncells);
+}
+
+void jonswapCDF::build(const jonswapEval &S, size_t ncells) {
+	JONSWAP_PROFILE_SCOPE(JONSWAP_STAGE_CDF);
+	if (ncells < 1)
+		ncells = 1;
+	h = wmax / ncells;
+
+	vector<double> w(ncells + 1), Sw(ncells + 1), area(ncells);
+	for (size_t i = 0; i <= ncells; i++)
+		w[i] = i * h;
+	w[ncells] = wmax;
+	S(&w[0], &Sw[0], ncells + 1);
+
+	jonswapQuad quad(8);
+	quad.integrate(S, &w[0], ncells, &area[0]);
+
+	E.resize(ncells + 1);
+	dE0.resize(ncells);
+	dE1.resize(ncells);
+	E[0] = 0;
+	for (size_t i = 0; i < ncells; i++) {
+		E[i + 1] = E[i] + area[i];
+
+		// slopes in units of the cell, limited to keep the cubic monotone
+		double a = Sw[i] * h, b = Sw[i + 1] * h;
+		double d = area[i];
+		if (d > 0) {
+			double ra = a / d, rb = b / d;
+			double r2 = ra * ra + rb * rb;
+			if (r2 > 9) {
+				double tau = 3 / sqrt(r2);
+				a *= tau;
+				b *= tau;
+			}
+		} else {
+			a = b = 0;
+		}
+		dE0[i] = a;
+		dE1[i] = b;
+	}
+}
+
+double jonswapCDF::energy(double w) const {
+	if (w <= 0)
+		return 0;
+	if (w >= wmax)
+		return E.back();
+
+	size_t i = (size_t) (w / h);
+	if (i >= dE0.size())
+		i = dE0.size() - 1;
+	double t = w / h - i;
+	double t2 = t * t, t3 = t2 * t;
+
+	double h00 = 2*t3 - 3*t2 + 1;
+	double h10 = t3 - 2*t2 + t;
+	double h01 = -2*t3 + 3*t2;
+	double h11 = t3 - t2;
+	return h00 * E[i] + h10 * dE0[i] + h01 * E[i + 1] + h11 * dE1[i];
+}
+
+void jonswapCDF::binEnergies(const double *edges, size_t nbins, double *area) const {
+	double lo = energy(edges[0]);
+	for (size_t i = 0; i < nbins; i++) {
+		double hi = energy(edges[i + 1]);
+		area[i] = hi - lo;
+		lo = hi;
+	}
+}
+
+// w in cell i with E(w) = e, E[i] <= e <= E[i+1]. The cubic is monotone, so
+// Newton steps that leave the bracket fall back to bisection. t to 1e-13 of
+// a cell is as close as rounding of the cubic allows.
+double jonswapCDF::solveCell(size_t i, double e) const {
+	double lo = 0, hi = 1;
+	double d = E[i + 1] - E[i];
+	double t = d > 0 ? (e - E[i]) / d : 0;
+
+	for (int it = 0; it < 50; it++) {
+		double t2 = t * t, t3 = t2 * t;
+		double f = (2*t3 - 3*t2 + 1) * E[i] + (t3 - 2*t2 + t) * dE0[i]
+			+ (-2*t3 + 3*t2) * E[i + 1] + (t3 - t2) * dE1[i] - e;
+		if (f == 0)
+			break;
+		if (f > 0)
+			hi = t;
+		else
+			lo = t;
+		double df = (6*t2 - 6*t) * (E[i] - E[i + 1]) + (3*t2 - 4*t + 1) * dE0[i] + (3*t2 - 2*t) * dE1[i];
+		double next = df > 0 ? t - f / df : lo - 1;
+		if (next <= lo || next >= hi)
+			next = (lo + hi) / 2;
+		if (fabs(next - t) < 1e-13)
+			break;
+		t = next;
+	}
+	double w = (i + t) * h;
+	return w < wmax ? w : wmax;
+}
+
+double jonswapCDF::quantile(double p) const {
+	double e = p * E.back();
+	if (p <= 0)
+		return 0;
+	if (e >= E.back())
+		return wmax;
+	size_t i = std::upper_bound(E.begin(), E.end(), e) - E.begin() - 1;
+	return solveCell(i, e);
+}
+
+void jonswapCDF::quantiles(const double *p, size_t n, double *w) const {
+	size_t i = 0, last = dE0.size() - 1;
+	for (size_t k = 0; k < n; k++) {
+		double e = p[k] * E.back();
+		if (p[k] <= 0) {
+			w[k] = 0;
+			continue;
+		}
+		if (e >= E.back()) {
+			w[k] = wmax;
+			continue;
+		}
+		while (i < last && E[i + 1] <= e)
+			i++;
+		w[k] = solveCell(i, e);
+	}
+}
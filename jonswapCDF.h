@@ -0,0 +1,56 @@
+//
+//  jonswapCDF.h
+//
+//  Cumulative energy E(w) = integral of S from 0 to w on [0, wmax], built
+//  once per spectrum. E is tabulated on a uniform grid together with S, and
+//  a cubic Hermite through (E_i, S_i) interpolates each cell, so a query is
+//  O(1) and accurate to O(h^4). Derivatives are limited (Fritsch-Carlson)
+//  where needed so E stays monotone.
+//
+//  The energy of a bin is energy(a, b) = E(b) - E(a), with no integration.
+//  quantile() inverts E by a bracketed Newton solve inside one cell, which
+//  gives equal energy bin edges without any integration either.
+//
+
+#ifndef JONSWAPCDF_H
+#define JONSWAPCDF_H
+
+#include <vector>
+#include "jonswapEval.h"
+
+using std::vector;
+
+class jonswapCDF
+{
+public:
+	explicit jonswapCDF(const jonswapSpec &spec, size_t ncells = 2048);
+	jonswapCDF(const jonswapEval &S, double wmax, size_t ncells = 2048);
+
+	// E(w), 0 for w <= 0 and total() for w >= wmax
+	double energy(double w) const;
+
+	// energy between a and b
+	double energy(double a, double b) const { return energy(b) - energy(a); }
+
+	// energy of nbins bins given by nbins+1 edges
+	void binEnergies(const double *edges, size_t nbins, double *area) const;
+
+	// w with E(w) = p total(), p in [0, 1]
+	double quantile(double p) const;
+
+	// Same for n ascending p; walks the table once, so O(n + ncells)
+	void quantiles(const double *p, size_t n, double *w) const;
+
+	double total() const { return E.back(); }
+	double getWmax() const { return wmax; }
+
+private:
+	double wmax, h;
+	vector<double> E;        // E at the grid nodes
+	vector<double> dE0, dE1; // Hermite slopes at each cell's ends, times h
+
+	void build(const jonswapEval &S, size_t ncells);
+	double solveCell(size_t i, double e) const;
+};
+
+#endif
@@ -0,0 +1,146 @@
+//
+//  jonswapCache.cpp
+//
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <atomic>
+#include "jonswapCache.h"
+
+namespace {
+
+// FNV-1a over values fed as little-endian bytes
+class fnv1a {
+public:
+	fnv1a() : h(14695981039346656037ULL) {}
+
+	void bytes(const void *data, size_t n) {
+		const unsigned char *p = (const unsigned char *) data;
+		for (size_t i = 0; i < n; i++) {
+			h ^= p[i];
+			h *= 1099511628211ULL;
+		}
+	}
+
+	void u64(uint64_t v) {
+		unsigned char b[8];
+		for (int i = 0; i < 8; i++)
+			b[i] = (unsigned char) (v >> (8 * i));
+		bytes(b, 8);
+	}
+
+	// -0 hashes as 0
+	void f64(double v) {
+		uint64_t bits;
+		v = v == 0 ? 0.0 : v;
+		memcpy(&bits, &v, sizeof(bits));
+		u64(bits);
+	}
+
+	uint64_t value() const { return h; }
+
+private:
+	uint64_t h;
+};
+
+}
+
+jonswapCacheKey::jonswapCacheKey(const jonswapSpec &spec, int nbins, int nmems, double depth,
+		uint64_t seed)
+	: alpha(spec.getAlpha()), wp(spec.getWp()), wmax(spec.getWmax()), gamma(spec.getGamma()),
+	  s1(spec.getS1()), s2(spec.getS2()), nbins(nbins), nmems(nmems), depth(depth), seed(seed),
+	  paddle(spec.getPaddleModel()), peaks(spec.getPeakParams()) {
+}
+
+uint64_t jonswapCacheKey::hash() const {
+	fnv1a h;
+	h.bytes(JONSWAP_VERSION, strlen(JONSWAP_VERSION));
+	h.u64(JONSWAP_IO_VERSION);
+	h.f64(alpha);
+	h.f64(wp);
+	h.f64(wmax);
+	h.f64(gamma);
+	h.f64(s1);
+	h.f64(s2);
+	h.u64((uint64_t) (int64_t) nbins);
+	h.u64((uint64_t) (int64_t) nmems);
+	h.f64(depth);
+	h.u64(seed);
+	h.u64((uint64_t) paddle.type);
+	h.f64(paddle.type == JONSWAP_PADDLE_HINGED ? paddle.hinge : 0);
+	// nothing for a single peak, so its keys stay what they were
+	for (size_t k = 0; k < peaks.n; k++) {
+		h.f64(peaks.c[k]);
+		h.f64(peaks.wp[k]);
+		h.f64(peaks.lng[k]);
+		h.f64(peaks.ks0[k]);
+		h.f64(peaks.ks1[k]);
+	}
+	return h.value();
+}
+
+jonswapCache::jonswapCache(const std::string &dir) : dir(dir.empty() ? "." : dir) {
+}
+
+std::string jonswapCache::path(const jonswapCacheKey &k) const {
+	char name[32];
+	snprintf(name, sizeof(name), "jonswap-%016llx.bin", (unsigned long long) k.hash());
+	return dir + "/" + name;
+}
+
+bool jonswapCache::load(const jonswapCacheKey &k, jonswapMappedFile &f) const {
+	if (!f.open(path(k).c_str()))
+		return false;
+	// the hash covers the rest; this catches stale or foreign files
+	const jonswapFileHeader &h = f.header();
+	if (h.alpha != k.alpha || h.wp != k.wp || h.wmax != k.wmax || h.gamma != k.gamma
+			|| h.s1 != k.s1 || h.s2 != k.s2 || h.depth != k.depth
+			|| f.size(JONSWAP_IO_EDGES) != (size_t) k.nbins + 1
+			|| f.size(JONSWAP_IO_PADDLE) != (size_t) k.nbins) {
+		f.close();
+		return false;
+	}
+	return true;
+}
+
+bool jonswapCache::store(const jonswapCacheKey &k, const jonswapSpec &spec) const {
+	if (mkdir(dir.c_str(), 0777) != 0 && errno != EEXIST)
+		return false;
+	std::string final = path(k);
+	// unique per store, so threads writing the same entry don't collide
+	static std::atomic<unsigned> serial(0);
+	char suffix[48];
+	snprintf(suffix, sizeof(suffix), ".tmp%ld.%u", (long) getpid(), serial++);
+	std::string tmp = final + suffix;
+
+	const vector<double> none;
+	if (!jonswapWriteFile(tmp.c_str(), spec, none, none, k.depth)) {
+		unlink(tmp.c_str());
+		return false;
+	}
+	if (rename(tmp.c_str(), final.c_str()) != 0) {
+		unlink(tmp.c_str());
+		return false;
+	}
+	return true;
+}
+
+bool jonswapCache::get(jonswapSpec &spec, int nbins, int nmems, double depth, uint64_t seed,
+		jonswapMappedFile &f, bool *hit) const {
+	jonswapCacheKey k(spec, nbins, nmems, depth, seed);
+	if (load(k, f)) {
+		if (hit)
+			*hit = true;
+		return true;
+	}
+	if (hit)
+		*hit = false;
+
+	spec.bin(nbins, seed);
+	spec.calcBinAmps(nmems);
+	spec.calcPaddleAmps(depth);
+	return store(k, spec) && load(k, f);
+}
@@ -0,0 +1,63 @@
+//
+//  jonswapCache.h
+//
+//  On-disk cache of binned spectra. An entry holds the edges, centers,
+//  amps and paddle amps of one configuration (spectrum parameters, bin
+//  count, quadrature order, depth, paddle model and bin seed) as a
+//  jonswapIO file named after a 64 bit FNV-1a hash of the configuration
+//  and JONSWAP_VERSION. A hit maps the file and uses the arrays in place;
+//  nothing is parsed or recomputed.
+//
+//  Entries are written to a temporary file and renamed into place, so
+//  concurrent readers see either no entry or a complete one.
+//
+
+#ifndef JONSWAPCACHE_H
+#define JONSWAPCACHE_H
+
+#include <stdint.h>
+#include <string>
+#include "jonswapSpec.h"
+#include "jonswapIO.h"
+
+struct jonswapCacheKey {
+	double alpha, wp, wmax, gamma, s1, s2;
+	int nbins, nmems;
+	double depth;
+	uint64_t seed;
+	jonswapPaddleModel paddle;
+	jonswapPeakParams peaks;   // of a composite spectrum, n = 0 otherwise
+
+	// spec's parameters, peaks and paddle model
+	jonswapCacheKey(const jonswapSpec &spec, int nbins, int nmems, double depth, uint64_t seed);
+
+	// same on every host and build of the same JONSWAP_VERSION
+	uint64_t hash() const;
+};
+
+class jonswapCache
+{
+public:
+	// entries live in dir, which is created on the first store
+	explicit jonswapCache(const std::string &dir);
+
+	std::string path(const jonswapCacheKey &k) const;
+
+	// Map the entry of k into f; false on a miss
+	bool load(const jonswapCacheKey &k, jonswapMappedFile &f) const;
+
+	// Write spec's bins as the entry of k
+	bool store(const jonswapCacheKey &k, const jonswapSpec &spec) const;
+
+	// The bins of spec for (nbins, nmems, depth, seed) mapped into f. On a
+	// miss they are computed with bin(nbins, seed), calcBinAmps(nmems) and
+	// calcPaddleAmps(depth) and stored first. Returns false only if f could
+	// not be mapped; hit tells whether the entry was there.
+	bool get(jonswapSpec &spec, int nbins, int nmems, double depth, uint64_t seed,
+			jonswapMappedFile &f, bool *hit = NULL) const;
+
+private:
+	std::string dir;
+};
+
+#endif
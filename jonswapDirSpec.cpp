@@ -0,0 +1,208 @@
+//
+//  jonswapDirSpec.cpp
+//
+
+#include <math.h>
+#include <algorithm>
+#include "jonswapDirSpec.h"
+#include "jonswapPipeline.h"
+#include "jonswapPool.h"
+#include "jonswapRng.h"
+
+// frequency bins per tile: FTILE x ndir phasors and steps stay in L1/L2
+static const size_t FTILE = 32;
+// fewest paddles handed to a worker at a time
+static const size_t GRAIN = 8;
+// Simpson panels per direction bin for D_j
+static const int DIR_PANELS = 32;
+
+jonswapDirSpec::jonswapDirSpec(const jonswapSpec &spec, jonswapSpreading type, double spread,
+		double theta0)
+	: jonswapSpec(spec) {
+	setSpreading(type, spread, theta0);
+	binDirections(1);
+}
+
+void jonswapDirSpec::setSpreading(jonswapSpreading type, double spread, double theta0) {
+	this->type = type;
+	this->spread = spread;
+	this->theta0 = theta0;
+	norm = type == JONSWAP_SPREAD_COS2S
+		? exp(lgamma(spread + 1) - lgamma(spread + 0.5)) / (2 * sqrt(M_PI)) : 0;
+	if (!thetaEdges.empty())
+		setDirBins();
+}
+
+double jonswapDirSpec::spreading(double theta) const {
+	double d = remainder(theta - theta0, 2 * M_PI);
+	if (type == JONSWAP_SPREAD_COS2S)
+		return norm * pow(cos(d / 2), 2 * spread);
+
+	// images 2 pi k until exp(-(2 pi k)^2 / 2 sigma^2) is negligible
+	int images = (int) ceil(spread * 9 / (2 * M_PI)) + 1;
+	double sum = 0;
+	for (int k = -images; k <= images; k++) {
+		double x = (d + 2 * M_PI * k) / spread;
+		sum += exp(-x * x / 2);
+	}
+	return sum / (spread * sqrt(2 * M_PI));
+}
+
+void jonswapDirSpec::binDirections(int n, double halfWidth) {
+	if (n < 1)
+		n = 1;
+	thetaEdges.resize(n + 1);
+	for (int i = 0; i <= n; i++)
+		thetaEdges[i] = theta0 - halfWidth + i * 2 * halfWidth / n;
+	setDirBins();
+}
+
+void jonswapDirSpec::binDirections(int n, uint64_t seed, double halfWidth) {
+	if (n < 1)
+		n = 1;
+	jonswapRng rng(seed);
+	jonswapJitterEdges(2 * halfWidth, n, rng, thetaEdges);
+	for (size_t i = 0; i < thetaEdges.size(); i++)
+		thetaEdges[i] += theta0 - halfWidth;
+	setDirBins();
+}
+
+// centers and energy shares of the direction bins
+void jonswapDirSpec::setDirBins() {
+	size_t n = thetaEdges.size() - 1;
+	thetas.resize(n);
+	dirWeights.resize(n);
+	dirAmps.resize(n);
+
+	double total = 0;
+	for (size_t j = 0; j < n; j++) {
+		double a = thetaEdges[j], b = thetaEdges[j + 1];
+		double h = (b - a) / DIR_PANELS;
+		double sum = spreading(a) + spreading(b);
+		for (int k = 1; k < DIR_PANELS; k++)
+			sum += (k % 2 ? 4 : 2) * spreading(a + k * h);
+		thetas[j] = (a + b) / 2;
+		dirWeights[j] = sum * h / 3;
+		total += dirWeights[j];
+	}
+	for (size_t j = 0; j < n; j++) {
+		dirWeights[j] = total > 0 ? dirWeights[j] / total : 1.0 / n;
+		dirAmps[j] = sqrt(dirWeights[j]);
+	}
+}
+
+void jonswapDirSpec::getCellAmps(vector<double> &amps) const {
+	const jonswapBins &b = getBinData();
+	size_t nf = b.size(), nd = dirAmps.size();
+	amps.resize(nf * nd);
+	for (size_t i = 0; i < nf; i++) {
+		double a = sqrt(2 * b.amps[i] * b.width[i]);
+		for (size_t j = 0; j < nd; j++)
+			amps[i * nd + j] = a * dirAmps[j];
+	}
+}
+
+void jonswapDirSpec::getCellPaddleAmps(vector<double> &amps) const {
+	const jonswapBins &b = getBinData();
+	size_t nf = b.paddleAmps.size(), nd = dirAmps.size();
+	amps.resize(nf * nd);
+	for (size_t i = 0; i < nf; i++)
+		for (size_t j = 0; j < nd; j++)
+			amps[i * nd + j] = b.paddleAmps[i] * dirAmps[j];
+}
+
+namespace {
+
+struct arrayJob {
+	const jonswapPaddleArray *paddles;
+	size_t nf, nd;
+	const double *k, *X, *phi, *sinTheta, *d;
+	const double *rr, *ri;   // phasor step from one paddle to the next, per cell
+	double *amp, *phase;
+
+	// paddles [p0, p1), all frequencies
+	void run(size_t p0, size_t p1) const {
+		vector<double> zr(FTILE * nd), zi(FTILE * nd);
+		double y0 = paddles->y0 + p0 * paddles->spacing;
+
+		for (size_t i0 = 0; i0 < nf; i0 += FTILE) {
+			size_t ni = nf - i0 < FTILE ? nf - i0 : FTILE;
+
+			// phasors at the first paddle of the block
+			for (size_t i = 0; i < ni; i++) {
+				for (size_t j = 0; j < nd; j++) {
+					double ph = phi[(i0 + i) * nd + j] - k[i0 + i] * sinTheta[j] * y0;
+					zr[i * nd + j] = d[j] * cos(ph);
+					zi[i * nd + j] = d[j] * sin(ph);
+				}
+			}
+
+			for (size_t p = p0; p < p1; p++) {
+				for (size_t i = 0; i < ni; i++) {
+					double *pr = &zr[i * nd], *pi = &zi[i * nd];
+					const double *sr = rr + (i0 + i) * nd, *si = ri + (i0 + i) * nd;
+					double re = 0, im = 0;
+					for (size_t j = 0; j < nd; j++) {
+						re += pr[j];
+						im += pi[j];
+						double t = pr[j] * sr[j] - pi[j] * si[j];
+						pi[j] = pr[j] * si[j] + pi[j] * sr[j];
+						pr[j] = t;
+					}
+					amp[p * nf + i0 + i] = X[i0 + i] * sqrt(re * re + im * im);
+					phase[p * nf + i0 + i] = atan2(im, re);
+				}
+			}
+		}
+	}
+};
+
+}
+
+bool jonswapDirSpec::calcArrayAmps(const jonswapPaddleArray &paddles, uint64_t seed, jonswapPool *pool) {
+	double h = getDepth();
+	if (!(h > 0))
+		return false;
+	const jonswapBins &b = getBinData();
+	size_t nf = b.size(), nd = dirAmps.size();
+	// bins with paddle amps (a depth alone doesn't compute them), a
+	// direction and a paddle
+	if (!(nf > 0 && b.paddleAmps.size() == nf && nd > 0 && paddles.count > 0))
+		return false;
+
+	vector<double> k(nf), sinTheta(nd);
+	jonswapDispersion(&b.wc[0], nf, h, &k[0], 3, getG());
+	for (size_t i = 0; i < nf; i++)
+		k[i] /= h;
+	for (size_t j = 0; j < nd; j++)
+		sinTheta[j] = sin(thetas[j]);
+
+	jonswapRng rng(seed);
+	cellPhase.resize(nf * nd);
+	for (size_t c = 0; c < cellPhase.size(); c++)
+		cellPhase[c] = 2 * M_PI * rng.uniform();
+
+	vector<double> rr(nf * nd), ri(nf * nd);
+	for (size_t i = 0; i < nf; i++) {
+		for (size_t j = 0; j < nd; j++) {
+			double st = -k[i] * sinTheta[j] * paddles.spacing;
+			rr[i * nd + j] = cos(st);
+			ri[i * nd + j] = sin(st);
+		}
+	}
+
+	arrayAmp.resize(paddles.count * nf);
+	arrayPhase.resize(paddles.count * nf);
+	arrayJob job = { &paddles, nf, nd, &k[0], &b.paddleAmps[0], &cellPhase[0], &sinTheta[0],
+		&dirAmps[0], &rr[0], &ri[0], &arrayAmp[0], &arrayPhase[0] };
+	// every block starts with exact phasors, so blocks are as large as the
+	// pool allows
+	size_t grain = pool ? std::max(GRAIN, (paddles.count + pool->size() - 1) / pool->size()) : 0;
+	if (pool)
+		pool->parallelFor(paddles.count, grain, [&](size_t begin, size_t end, unsigned) {
+			job.run(begin, end);
+		});
+	else
+		job.run(0, paddles.count);
+	return true;
+}
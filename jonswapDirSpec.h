@@ -0,0 +1,96 @@
+//
+//  jonswapDirSpec.h
+//
+//  Directional spectrum S(w, theta) = S_J(w) D(theta - theta0) with cos-2s
+//
+//      D = G(s) cos^2s(dtheta / 2),  G(s) = Gamma(s+1) / (2 sqrt(pi) Gamma(s+1/2))
+//
+//  or wrapped normal spreading of standard deviation sigma. Frequencies
+//  are binned by the jonswapSpec base; directions get bins of their own,
+//  each with its share D_j of the energy (normalized over the binned
+//  range). The product is separable, so the amplitude of cell (i, j) is the
+//  outer product a_i d_j of two 1-D arrays, a_i = sqrt(2 E_i) and
+//  d_j = sqrt(D_j).
+//
+//  For a line of paddles at y_p along the wavemaker, paddle p moves as
+//
+//      X_p(t) = sum_ij X_i d_j cos(w_i t - k_i y_p sin theta_j + phi_ij)
+//             = sum_i  A_pi cos(w_i t + psi_pi)
+//
+//  (snake principle, X_i the 2-D stroke of frequency bin i), so the
+//  directions collapse into one amplitude and phase per paddle and
+//  frequency. calcArrayAmps() evaluates the sum over j in frequency tiles
+//  that stay in cache, stepping the phasors from paddle to paddle with a
+//  complex multiply, and hands blocks of paddles to a jonswapPool.
+//
+
+#ifndef JONSWAPDIRSPEC_H
+#define JONSWAPDIRSPEC_H
+
+#include <stdint.h>
+#include "jonswapSpec.h"
+
+class jonswapPool;
+
+enum jonswapSpreading {
+	JONSWAP_SPREAD_COS2S = 0,      // spread is s
+	JONSWAP_SPREAD_WRAPPED_NORMAL  // spread is sigma in rad
+};
+
+// count paddles at y0, y0 + spacing, ...
+struct jonswapPaddleArray {
+	size_t count;
+	double spacing, y0;
+
+	jonswapPaddleArray(size_t count = 1, double spacing = 1, double y0 = 0)
+		: count(count), spacing(spacing), y0(y0) {}
+};
+
+class jonswapDirSpec : public jonswapSpec
+{
+public:
+	jonswapDirSpec(const jonswapSpec &spec, jonswapSpreading type, double spread, double theta0 = 0);
+
+	void setSpreading(jonswapSpreading type, double spread, double theta0 = 0);
+
+	// D(theta), normalized over [-pi, pi)
+	double spreading(double theta) const;
+
+	// n direction bins over theta0 +- halfWidth, uniform or jittered as bin()
+	void binDirections(int n, double halfWidth = M_PI);
+	void binDirections(int n, uint64_t seed, double halfWidth = M_PI);
+
+	const vector<double> &getThetaEdges() const { return thetaEdges; }
+	const vector<double> &getThetas() const { return thetas; }
+	// D_j, summing to 1
+	const vector<double> &getDirWeights() const { return dirWeights; }
+
+	// sqrt(2 E_i) d_j (cells) or X_i d_j (paddle strokes of a single paddle),
+	// nfreq x ndir row major
+	void getCellAmps(vector<double> &amps) const;
+	void getCellPaddleAmps(vector<double> &amps) const;
+
+	// Amplitude and phase of every frequency bin for every paddle, with the
+	// cell phases drawn from seed. Needs the paddle amps, i.e. a
+	// calcPaddleAmps(h) or setDepth(h) first; returns false without a depth,
+	// without paddle amps for every bin, or for an empty array.
+	bool calcArrayAmps(const jonswapPaddleArray &paddles, uint64_t seed, jonswapPool *pool = NULL);
+
+	// count x nfreq row major, one row per paddle
+	const vector<double> &getArrayAmps() const { return arrayAmp; }
+	const vector<double> &getArrayPhases() const { return arrayPhase; }
+	// cell phases phi_ij of the last calcArrayAmps
+	const vector<double> &getCellPhases() const { return cellPhase; }
+
+private:
+	jonswapSpreading type;
+	double spread, theta0;
+	double norm;   // G(s), or unused for wrapped normal
+
+	vector<double> thetaEdges, thetas, dirWeights, dirAmps;
+	vector<double> arrayAmp, arrayPhase, cellPhase;
+
+	void setDirBins();
+};
+
+#endif
@@ -0,0 +1,147 @@
+//
+//  jonswapEdges.cpp
+//
+
+#include <math.h>
+#include <stdint.h>
+#include "jonswapEdges.h"
+#include "jonswapCDF.h"
+
+// base 2 radical inverse of i
+static double vanDerCorput(uint64_t i) {
+	double x = 0, f = 0.5;
+	for (; i; i >>= 1, f *= 0.5)
+		if (i & 1)
+			x += f;
+	return x;
+}
+
+// uniform spacing: positions t in (0, 1) to frequencies
+static void scaleEdges(double *t, size_t m, double wmax) {
+	for (size_t i = 0; i < m; i++)
+		t[i] *= wmax;
+}
+
+double jonswapNormalCDF(double x) {
+	return 0.5 * erfc(-x * M_SQRT1_2);
+}
+
+// Acklam's rational approximation (1e-9), then one Halley step on the cdf
+double jonswapNormalQuantile(double p) {
+	static const double a[] = { -3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+		1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00 };
+	static const double b[] = { -5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+		6.680131188771972e+01, -1.328068155288572e+01 };
+	static const double c[] = { -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+		-2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00 };
+	static const double d[] = { 7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+		3.754408661907416e+00 };
+
+	if (p <= 0)
+		return -INFINITY;
+	if (p >= 1)
+		return INFINITY;
+
+	double x;
+	if (p < 0.02425 || p > 1 - 0.02425) {
+		double q = sqrt(-2 * log(p < 0.5 ? p : 1 - p));
+		x = (((((c[0]*q + c[1])*q + c[2])*q + c[3])*q + c[4])*q + c[5]) /
+			((((d[0]*q + d[1])*q + d[2])*q + d[3])*q + 1);
+		if (p > 0.5)
+			x = -x;
+	} else {
+		double q = p - 0.5, r = q * q;
+		x = (((((a[0]*r + a[1])*r + a[2])*r + a[3])*r + a[4])*r + a[5]) * q /
+			(((((b[0]*r + b[1])*r + b[2])*r + b[3])*r + b[4])*r + 1);
+	}
+
+	double e = jonswapNormalCDF(x) - p;
+	double u = e * sqrt(2 * M_PI) * exp(x * x / 2);
+	return x - u / (1 + x * u / 2);
+}
+
+void jonswapEdges(const jonswapEdgeOptions &o, double wmax, int n, jonswapRng &rng,
+		vector<double> &edges) {
+	if (n < 1)
+		n = 1;
+	edges.resize(n + 1);
+	double *t = &edges[1];
+	size_t m = n - 1;
+	double jitter = o.jitter < 0 ? 0 : o.jitter < 1 ? o.jitter : 0.999;
+
+	double shift = o.sampling == JONSWAP_SAMPLING_HALTON ? rng.uniform() : 0;
+	for (size_t i = 0; i < m; i++) {
+		double u;
+		if (o.sampling == JONSWAP_SAMPLING_HALTON) {
+			u = vanDerCorput(i + 1) + shift;
+			if (u >= 1)
+				u -= 1;
+		} else {
+			u = rng.uniform();
+		}
+		t[i] = (i + 1 + jitter * (u - 0.5)) / n;
+	}
+
+	switch (o.spacing) {
+	case JONSWAP_SPACING_NORMAL: {
+		double lo = jonswapNormalCDF(-o.mu / o.sigma);
+		double hi = jonswapNormalCDF((wmax - o.mu) / o.sigma);
+		for (size_t i = 0; i < m; i++) {
+			double w = o.mu + o.sigma * jonswapNormalQuantile(lo + t[i] * (hi - lo));
+			t[i] = w > 0 ? (w < wmax ? w : wmax) : 0;
+		}
+		break;
+	}
+	case JONSWAP_SPACING_ENERGY:
+		// no table: fall back to uniform
+		if (o.cdf)
+			o.cdf->quantiles(t, m, t);
+		else
+			scaleEdges(t, m, wmax);
+		break;
+	case JONSWAP_SPACING_UNIFORM:
+		scaleEdges(t, m, wmax);
+		break;
+	}
+	edges[0] = 0;
+	edges[n] = wmax;
+}
+
+int jonswapEnergyEdges(const jonswapCDF &cdf, double maxEnergy, double maxWidth,
+		vector<double> &edges) {
+	double wmax = cdf.getWmax();
+	if (!(maxEnergy > 0) && !(maxWidth > 0))
+		maxEnergy = 1;
+	edges.assign(1, 0.0);
+
+	double w = 0, p = 0;
+	while (w < wmax) {
+		double next = wmax;
+		if (maxEnergy > 0 && p + maxEnergy < 1)
+			next = cdf.quantile(p + maxEnergy);
+		if (maxWidth > 0 && w + maxWidth < next)
+			next = w + maxWidth;
+		// a flat stretch of E, or rounding, must not stall the walk
+		if (!(next > w))
+			next = fmin(wmax, w + (maxWidth > 0 ? maxWidth : wmax * 1e-9));
+		if (wmax - next < 1e-9 * wmax)
+			next = wmax;
+		edges.push_back(next);
+		w = next;
+		p = cdf.energy(w) / cdf.total();
+	}
+	return (int) edges.size() - 1;
+}
+
+double jonswapEffectiveComponents(const double *energy, size_t n) {
+	double total = 0, sq = 0;
+	for (size_t i = 0; i < n; i++)
+		total += energy[i];
+	if (!(total > 0))
+		return 0;
+	for (size_t i = 0; i < n; i++) {
+		double q = energy[i] / total;
+		sq += q * q;
+	}
+	return 1 / sq;
+}
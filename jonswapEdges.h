@@ -0,0 +1,77 @@
+//
+//  jonswapEdges.h
+//
+//  O(n) bin edge generation with no rejection. n-1 sorted points t_i in
+//  (0, 1), one per stratum,
+//
+//      t_i = (i + jitter (u_i - 1/2)) / n,   i = 1 .. n-1,
+//
+//  are mapped through the inverse of a distribution on [0, wmax]: uniform,
+//  a normal (the JONSWAP_BINS_NORMAL density, truncated to (0, wmax)
+//  instead of redrawing) or the spectrum's own energy, for equal energy
+//  bins. Strata never overlap for jitter < 1, so edges come out strictly
+//  increasing straight into the array.
+//
+//  The u_i are either independent draws (stratified jitter) or the base 2
+//  van der Corput sequence rotated by one draw (Halton), which spreads the
+//  offsets evenly over the bins of one realization.
+//
+//  jonswapEnergyEdges() sizes the bins by energy and width bounds instead
+//  of a count.
+//
+
+#ifndef JONSWAPEDGES_H
+#define JONSWAPEDGES_H
+
+#include <vector>
+#include "jonswapRng.h"
+
+using std::vector;
+
+class jonswapCDF;
+
+enum jonswapEdgeSpacing {
+	JONSWAP_SPACING_UNIFORM = 0,
+	JONSWAP_SPACING_NORMAL,     // density of N(mu, sigma) on (0, wmax)
+	JONSWAP_SPACING_ENERGY      // equal energy per bin, needs a jonswapCDF
+};
+
+enum jonswapEdgeSampling {
+	JONSWAP_SAMPLING_STRATIFIED = 0,
+	JONSWAP_SAMPLING_HALTON
+};
+
+struct jonswapEdgeOptions {
+	jonswapEdgeSpacing spacing;
+	jonswapEdgeSampling sampling;
+	double jitter;            // fraction of a stratum, in [0, 1)
+	double mu, sigma;         // JONSWAP_SPACING_NORMAL
+	const jonswapCDF *cdf;    // JONSWAP_SPACING_ENERGY, not owned
+
+	jonswapEdgeOptions(jonswapEdgeSpacing spacing = JONSWAP_SPACING_UNIFORM,
+			jonswapEdgeSampling sampling = JONSWAP_SAMPLING_STRATIFIED, double jitter = 0.8)
+		: spacing(spacing), sampling(sampling), jitter(jitter), mu(0), sigma(1), cdf(NULL) {}
+};
+
+// n bins over [0, wmax] into edges (n + 1 values, 0 and wmax included)
+void jonswapEdges(const jonswapEdgeOptions &o, double wmax, int n, jonswapRng &rng,
+		vector<double> &edges);
+
+// Error bounded energy bins over [0, cdf.getWmax()]: each bin carries at
+// most maxEnergy of the total and is at most maxWidth wide (0 for no
+// limit), so the bins crowd around the peak and the tail is still
+// resolved. Edges are placed greedily from 0; returns the bin count.
+int jonswapEnergyEdges(const jonswapCDF &cdf, double maxEnergy, double maxWidth,
+		vector<double> &edges);
+
+// 1 / sum p_i^2 with p_i the share of bin i in the total energy. A random
+// phase sum of n components has excess kurtosis -1.5 / neff, so this is the
+// number of equal components giving the same Gaussianity: n for equal
+// energy bins, a fraction of n for uniform ones.
+double jonswapEffectiveComponents(const double *energy, size_t n);
+
+// standard normal cdf and its inverse
+double jonswapNormalCDF(double x);
+double jonswapNormalQuantile(double p);
+
+#endif
@@ -0,0 +1,70 @@
+//
+//  jonswapEnsemble.cpp
+//
+
+#include <string.h>
+#include <atomic>
+#include "jonswapEnsemble.h"
+
+// realizations handed to a worker at a time
+static const size_t GRAIN = 4;
+
+jonswapEnsemble::jonswapEnsemble(const jonswapSpec &spec, jonswapPool &pool)
+	: pool(pool), pipelines(pool.size(), jonswapPipeline(spec)), scratch(pool.size()) {
+}
+
+void jonswapEnsemble::setBinMode(jonswapBinMode mode) {
+	for (size_t i = 0; i < pipelines.size(); i++)
+		pipelines[i].setBinMode(mode);
+}
+
+void jonswapEnsemble::setPaddleModel(const jonswapPaddleModel &model) {
+	for (size_t i = 0; i < pipelines.size(); i++)
+		pipelines[i].setPaddleModel(model);
+}
+
+void jonswapEnsemble::setEdgeOptions(const jonswapEdgeOptions &o) {
+	pipelines[0].setEdgeOptions(o);
+	for (size_t i = 1; i < pipelines.size(); i++)
+		pipelines[i].setEdgeOptions(pipelines[0].getEdgeOptions());
+}
+
+void jonswapEnsemble::run(uint64_t seed, size_t first, size_t count, int nbins, int nmems, double h,
+		vector<jonswapBins> &out) {
+	out.resize(count);
+	pool.parallelFor(count, GRAIN, [&](size_t begin, size_t end, unsigned worker) {
+		jonswapPipeline &p = pipelines[worker];
+		for (size_t i = begin; i < end; i++) {
+			p.seed(jonswapRng::streamSeed(seed, first + i));
+			p.run(nbins, nmems, h, out[i]);
+		}
+	});
+}
+
+bool jonswapEnsemble::run(uint64_t seed, size_t first, size_t count, int nbins, int nmems, double h,
+		double *wc, double *amps, double *paddleAmps) {
+	if (nbins < 1)
+		return false;
+	std::atomic<bool> ok(true);
+	pool.parallelFor(count, GRAIN, [&](size_t begin, size_t end, unsigned worker) {
+		jonswapPipeline &p = pipelines[worker];
+		jonswapBins &bins = scratch[worker];
+		size_t n = nbins, row = n * sizeof(double);
+		for (size_t i = begin; i < end; i++) {
+			p.seed(jonswapRng::streamSeed(seed, first + i));
+			p.run(nbins, nmems, h, bins);
+			// every row must be nbins wide, or the copies run off the bins
+			if (bins.size() != n || bins.amps.size() != n || bins.paddleAmps.size() != n) {
+				ok = false;
+				continue;
+			}
+			if (wc)
+				memcpy(wc + i * n, &bins.wc[0], row);
+			if (amps)
+				memcpy(amps + i * n, &bins.amps[0], row);
+			if (paddleAmps)
+				memcpy(paddleAmps + i * n, &bins.paddleAmps[0], row);
+		}
+	});
+	return ok;
+}
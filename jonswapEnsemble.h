@@ -0,0 +1,46 @@
+//
+//  jonswapEnsemble.h
+//
+//  Many independent random bin realizations of one spectrum, spread over a
+//  jonswapPool. Realization i always bins with the random stream
+//  jonswapRng::stream(seed, i), whichever thread runs it, so an ensemble is
+//  reproducible from its seed and doesn't depend on the thread count.
+//
+
+#ifndef JONSWAPENSEMBLE_H
+#define JONSWAPENSEMBLE_H
+
+#include <stdint.h>
+#include <vector>
+#include "jonswapPipeline.h"
+#include "jonswapPool.h"
+
+using std::vector;
+
+class jonswapEnsemble
+{
+public:
+	jonswapEnsemble(const jonswapSpec &spec, jonswapPool &pool);
+
+	void setBinMode(jonswapBinMode mode);
+	void setPaddleModel(const jonswapPaddleModel &model);
+	// Energy spacing shares one CDF table between the workers
+	void setEdgeOptions(const jonswapEdgeOptions &o);
+
+	// Realizations first .. first+count-1 into out[0 .. count)
+	void run(uint64_t seed, size_t first, size_t count, int nbins, int nmems, double h,
+			vector<jonswapBins> &out);
+
+	// Same, as row-major [count x nbins] matrices in caller storage.
+	// Any of the pointers may be null. false for nbins < 1 or if a
+	// realization didn't come out nbins wide; its rows are left alone.
+	bool run(uint64_t seed, size_t first, size_t count, int nbins, int nmems, double h,
+			double *wc, double *amps, double *paddleAmps);
+
+private:
+	jonswapPool &pool;
+	vector<jonswapPipeline> pipelines;  // one workspace per pool worker
+	vector<jonswapBins> scratch;        // per worker, for the matrix form
+};
+
+#endif
@@ -0,0 +1,61 @@
+//
+//  jonswapEval.h
+//
+//  Compiled jonswap spectrum: every invariant of a jonswapSpec (alpha g^2,
+//  1.2 wp^4, log(gamma), 1/(2 s^2 wp^2)) is hoisted at construction, so a
+//  point costs one division and two exp() calls with no branch on sigma.
+//  A composite spectrum (jonswapMultiSpec) evaluates all its peaks in the
+//  same pass, with the division and the powers of 1/w shared.
+//
+//  A jonswapEval is immutable once built, so one instance can be shared by
+//  any number of threads.
+//
+
+#ifndef JONSWAPEVAL_H
+#define JONSWAPEVAL_H
+
+#include "jonswapSpec.h"
+#include "jonswapProfile.h"
+#include "jonswapKernel.h"
+
+class jonswapEval
+{
+public:
+	explicit jonswapEval(const jonswapSpec &spec)
+		: p(spec.getKernelParams()), m(spec.getPeakParams()) {}
+	explicit jonswapEval(const jonswapKernelParams &params) : p(params) { m.n = 0; }
+
+	// Spectrum at one angular frequency, w > 0
+	double operator()(double w) const {
+		JONSWAP_PROFILE_COUNT(JONSWAP_COUNT_EVALS, 1);
+		return m.n ? jonswapPeaksFormula(m, w) : jonswapFormula(p, w);
+	}
+
+	// Spectrum at n angular frequencies through the batch kernels
+	void operator()(const double *w, double *S, size_t n) const {
+		JONSWAP_PROFILE_COUNT(JONSWAP_COUNT_EVALS, n);
+		if (m.n)
+			jonswapBatchPeaks(m, w, S, n);
+		else
+			jonswapBatch(p, w, S, n);
+	}
+
+	// Same in float (see jonswapKernel.h for its accuracy)
+	void operator()(const float *w, float *S, size_t n) const {
+		JONSWAP_PROFILE_COUNT(JONSWAP_COUNT_EVALS, n);
+		if (m.n)
+			jonswapBatchPeaks(m, w, S, n);
+		else
+			jonswapBatch(p, w, S, n);
+	}
+
+	// the first peak; peaks() has all of them (n = 0 for a single one)
+	const jonswapKernelParams &params() const { return p; }
+	const jonswapPeakParams &peaks() const { return m; }
+
+private:
+	jonswapKernelParams p;
+	jonswapPeakParams m;
+};
+
+#endif
@@ -0,0 +1,53 @@
+//
+//  jonswapFFT.cpp
+//
+
+#include <math.h>
+#include "jonswapFFT.h"
+
+jonswapFFT::jonswapFFT(size_t size) : n(1) {
+	while (n < size)
+		n <<= 1;
+
+	cs.resize(n / 2);
+	sn.resize(n / 2);
+	for (size_t k = 0; k < n / 2; k++) {
+		cs[k] = cos(2 * M_PI * k / n);
+		sn[k] = sin(2 * M_PI * k / n);
+	}
+
+	rev.resize(n);
+	for (size_t i = 0, j = 0; i < n; i++) {
+		rev[i] = j;
+		size_t bit = n >> 1;
+		for (; bit && (j & bit); bit >>= 1)
+			j ^= bit;
+		j |= bit;
+	}
+}
+
+void jonswapFFT::transform(double *re, double *im, double sign) const {
+	for (size_t i = 0; i < n; i++) {
+		size_t j = rev[i];
+		if (i < j) {
+			double t = re[i]; re[i] = re[j]; re[j] = t;
+			t = im[i]; im[i] = im[j]; im[j] = t;
+		}
+	}
+
+	for (size_t len = 2; len <= n; len <<= 1) {
+		size_t half = len / 2, stride = n / len;
+		for (size_t i = 0; i < n; i += len) {
+			for (size_t k = 0; k < half; k++) {
+				double wr = cs[k * stride], wi = sign * sn[k * stride];
+				size_t a = i + k, b = a + half;
+				double xr = re[b] * wr - im[b] * wi;
+				double xi = re[b] * wi + im[b] * wr;
+				re[b] = re[a] - xr;
+				im[b] = im[a] - xi;
+				re[a] += xr;
+				im[a] += xi;
+			}
+		}
+	}
+}
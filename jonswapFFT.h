@@ -0,0 +1,37 @@
+//
+//  jonswapFFT.h
+//
+//  In-place complex radix-2 FFT on split re/im arrays. Twiddles and the
+//  bit reversal permutation are tabulated once per size, so a transform
+//  does no trigonometry and no allocation.
+//
+
+#ifndef JONSWAPFFT_H
+#define JONSWAPFFT_H
+
+#include <stddef.h>
+#include <vector>
+
+using std::vector;
+
+class jonswapFFT
+{
+public:
+	// n is rounded up to a power of two
+	explicit jonswapFFT(size_t n);
+
+	size_t size() const { return n; }
+
+	// X[k] = sum_j x[j] exp(-+2 pi i jk/n), unscaled
+	void forward(double *re, double *im) const { transform(re, im, -1.0); }
+	void inverse(double *re, double *im) const { transform(re, im, 1.0); }
+
+private:
+	size_t n;
+	vector<size_t> rev;       // bit reversal pairs i < rev[i]
+	vector<double> cs, sn;    // cos/sin(2 pi k/n), k < n/2
+
+	void transform(double *re, double *im, double sign) const;
+};
+
+#endif
@@ -0,0 +1,165 @@
+//
+//  jonswapFFTSynth.cpp
+//
+
+#include <math.h>
+#include <chrono>
+#include "jonswapFFTSynth.h"
+#include "jonswapSynth.h"
+#include "jonswapRng.h"
+#include "jonswapProfile.h"
+
+jonswapFFTSynth::jonswapFFTSynth(double fs, size_t n)
+	: fs(fs), fft(n < 4 ? 4 : n), seed(0), block(0), pos(0), randomAmps(false), have(0) {
+	size_t N = fft.size();
+	dw = 2 * M_PI * fs / N;
+	hop = N / 2;
+	surf.assign(N / 2 + 1, 0.0);
+	amp = surf;
+	win.resize(N);
+	for (size_t j = 0; j < N; j++)
+		win[j] = sin(M_PI * j / N);
+	re.resize(N);
+	im.resize(N);
+	ready.resize(hop);
+	tail.resize(hop);
+}
+
+void jonswapFFTSynth::setSpectrum(const jonswapEval &S, uint64_t s, bool random) {
+	size_t nk = surf.size();
+	vector<double> w(nk);
+	for (size_t k = 0; k < nk; k++)
+		w[k] = k * dw;
+	S(&w[0], &surf[0], nk);  // w = 0 gives 0
+	for (size_t k = 0; k < nk; k++)
+		surf[k] = sqrt(2 * surf[k] * dw);
+	surf[nk - 1] = 0;        // no Nyquist line, it has no phase
+	amp = surf;
+
+	seed = s;
+	randomAmps = random;
+	reset();
+}
+
+void jonswapFFTSynth::setPaddle(double h, const jonswapPaddleModel &model) {
+	size_t nk = surf.size();
+	vector<double> w(nk), HoS(nk);
+	for (size_t k = 0; k < nk; k++)
+		w[k] = k * dw;
+	jonswapDispersion(&w[0], nk, h, &HoS[0]);
+	jonswapTransfer(model, &HoS[0], nk, h, &HoS[0]);
+	for (size_t k = 0; k < nk; k++)
+		amp[k] = HoS[k] > 0 ? surf[k] / HoS[k] : 0;
+	reset();
+}
+
+template<class R> void jonswapFFTSynth::draw(R &rng, size_t k, double &a, double &phi) const {
+	phi = 2 * M_PI * rng.uniform();
+	a = amp[k];
+	if (randomAmps)
+		a *= sqrt(-log(1 - rng.uniform()));
+}
+
+void jonswapFFTSynth::realize(uint64_t index, double *x) {
+	size_t N = fft.size();
+	jonswapRng rng = jonswapRng::stream(seed, index);
+
+	re[0] = im[0] = 0;
+	re[hop] = im[hop] = 0;
+	for (size_t k = 1; k < hop; k++) {
+		double a, phi;
+		draw(rng, k, a, phi);
+		re[k] = re[N - k] = 0.5 * a * cos(phi);
+		im[k] = 0.5 * a * sin(phi);
+		im[N - k] = -im[k];
+	}
+	fft.inverse(&re[0], &im[0]);
+	if (x != &re[0])
+		for (size_t j = 0; j < N; j++)
+			x[j] = re[j];
+}
+
+void jonswapFFTSynth::gridComponents(uint64_t index, vector<double> &w, vector<double> &a,
+		vector<double> &phase) const {
+	jonswapRng rng = jonswapRng::stream(seed, index);
+	w.clear();
+	a.clear();
+	phase.clear();
+	for (size_t k = 1; k < hop; k++) {
+		double ak, phi;
+		draw(rng, k, ak, phi);
+		if (ak != 0) {
+			w.push_back(k * dw);
+			a.push_back(ak);
+			phase.push_back(phi);
+		}
+	}
+}
+
+// windowed block into the second half of the overlap
+void jonswapFFTSynth::nextBlock() {
+	realize(block++, &re[0]);
+	for (size_t j = 0; j < hop; j++) {
+		ready[j] = tail[j] + win[j] * re[j];
+		tail[j] = win[j + hop] * re[j + hop];
+	}
+	have = hop;
+}
+
+void jonswapFFTSynth::reset() {
+	// run up one block, so the record starts fully faded in
+	block = 0;
+	pos = 0;
+	tail.assign(hop, 0.0);
+	nextBlock();
+	have = 0;
+}
+
+void jonswapFFTSynth::generate(double *out, size_t n) {
+	JONSWAP_PROFILE_SCOPE(JONSWAP_STAGE_SYNTH);
+	JONSWAP_PROFILE_COUNT(JONSWAP_COUNT_SAMPLES, n);
+	while (n > 0) {
+		if (have == 0)
+			nextBlock();
+		size_t m = have < n ? have : n;
+		const double *src = &ready[hop - have];
+		for (size_t j = 0; j < m; j++)
+			out[j] = src[j];
+		have -= m;
+		pos += m;
+		out += m;
+		n -= m;
+	}
+}
+
+typedef std::chrono::steady_clock crossoverClock;
+
+template<class F> static double perSample(F f, size_t samples) {
+	int reps = 0;
+	crossoverClock::time_point start = crossoverClock::now();
+	double t;
+	do {
+		f();
+		reps++;
+		t = std::chrono::duration<double>(crossoverClock::now() - start).count();
+	} while (t < 0.05);
+	return t / reps / samples;
+}
+
+size_t jonswapSynthCrossover(double fs, size_t n) {
+	const size_t probe = 256;
+	jonswapFFTSynth fsynth(fs, n);
+	size_t samples = fsynth.size();
+	vector<double> out(samples);
+
+	// the cost of the FFT path doesn't depend on the amplitudes
+	vector<double> w(probe), a(probe, 1.0);
+	for (size_t i = 0; i < probe; i++)
+		w[i] = (i + 1) * fsynth.resolution();
+	jonswapSynth direct(fs);
+	direct.setComponents(&w[0], &a[0], probe, 0);
+
+	double tDirect = perSample([&]() { direct.generate(&out[0], samples); }, samples) / probe;
+	double tFFT = perSample([&]() { fsynth.generate(&out[0], samples); }, samples);
+	return (size_t) ceil(tFFT / tDirect);
+}
@@ -0,0 +1,89 @@
+//
+//  jonswapFFTSynth.h
+//
+//  Spectral realization of a jonswap spectrum on a uniform FFT grid, for
+//  bin counts where the direct sum of jonswapSynth gets too slow.
+//
+//  Grid line k of an N point block is w_k = 2 pi k fs/N with amplitude
+//  sqrt(2 S(w_k) dw), dw = 2 pi fs/N, optionally Rayleigh distributed, and
+//  a uniform random phase; one inverse FFT gives the N samples of
+//  sum_k a_k cos(w_k t + phi_k). Every block draws its own amplitudes and
+//  phases from jonswapRng::stream(seed, block), and blocks are crossfaded
+//  with a sqrt-Hann window at hop N/2. The squared window sums to one, so
+//  the record is stationary with the target spectrum, does not repeat
+//  with period N, and can be as long as wanted with O(N) memory.
+//
+//  A sample costs O(log N) whatever the number of grid lines, against
+//  O(nbins) for the direct sum; jonswapSynthCrossover measures where the
+//  two meet on this machine.
+//
+
+#ifndef JONSWAPFFTSYNTH_H
+#define JONSWAPFFTSYNTH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "jonswapEval.h"
+#include "jonswapFFT.h"
+#include "jonswapPaddle.h"
+
+using std::vector;
+
+class jonswapFFTSynth
+{
+public:
+	// fs in samples per second, n (rounded up to a power of two) grid size
+	jonswapFFTSynth(double fs, size_t n);
+
+	// Grid amplitudes from the spectrum; restarts at t = 0
+	void setSpectrum(const jonswapEval &S, uint64_t seed, bool randomAmps = false);
+
+	// Turn surface elevation into paddle stroke for depth h: every grid
+	// amplitude is the spectrum's over H/S(k_k h) of the model. Call after
+	// setSpectrum; a second call replaces the first.
+	void setPaddle(double h, const jonswapPaddleModel &model = jonswapPaddleModel());
+
+	// back to t = 0 with the same seed
+	void reset();
+
+	// next n samples of the overlap-added record into out
+	void generate(double *out, size_t n);
+
+	// Block index by itself, unwindowed: x[j] = sum_k a_k cos(w_k j/fs + phi_k)
+	// for j < size(); the same sum as jonswapSynth over gridComponents().
+	void realize(uint64_t index, double *x);
+
+	// Grid lines of block index with nonzero amplitude, as jonswapSynth input
+	void gridComponents(uint64_t index, vector<double> &w, vector<double> &amp,
+			vector<double> &phase) const;
+
+	size_t size() const { return fft.size(); }
+	double rate() const { return fs; }
+	double resolution() const { return dw; }
+	uint64_t position() const { return pos; }
+
+private:
+	double fs, dw;
+	jonswapFFT fft;
+	size_t hop;
+	uint64_t seed, block, pos;
+	bool randomAmps;
+
+	vector<double> surf;        // surface amplitude per grid line, k <= N/2
+	vector<double> amp;         // what is synthesised: surf, or over H/S
+	vector<double> win;         // sqrt-Hann
+	vector<double> re, im;      // FFT workspace
+	vector<double> ready, tail; // output half block, overlap for the next one
+	size_t have;                // samples of ready not yet handed out
+
+	// amplitude and phase of grid line k, drawn in order from rng
+	template<class R> void draw(R &rng, size_t k, double &a, double &phi) const;
+	void nextBlock();
+};
+
+// Components above which jonswapFFTSynth with an n point grid produces
+// samples faster than jonswapSynth, timed on this machine
+size_t jonswapSynthCrossover(double fs, size_t n);
+
+#endif
@@ -0,0 +1,107 @@
+//
+//  jonswapFixed.h
+//
+//  jonswap spectrum with gamma, s1 and s2 fixed at compile time by a shape
+//  struct, so log(gamma) and 1/(2 s^2) are constants the compiler can fold.
+//  A shape with gamma = 1 is the Pierson-Moskowitz spectrum and skips the
+//  peak enhancement exponential entirely.
+//
+//  The formula itself is the one in jonswapKernel.h used by jonswapSpec and
+//  jonswapEval.
+//
+
+#ifndef JONSWAPFIXED_H
+#define JONSWAPFIXED_H
+
+#include <type_traits>
+#include "jonswapKernel.h"
+
+// jonswapSpec(alpha, wp, wmax) defaults
+struct jonswapDefaultShape {
+	static constexpr double gamma = 3.3;
+	static constexpr double s1 = 0.07;
+	static constexpr double s2 = 0.09;
+};
+
+// jonswapSpec(vel10, F) values
+struct jonswapWindShape {
+	static constexpr double gamma = 3.3;
+	static constexpr double s1 = 0.7;
+	static constexpr double s2 = 0.9;
+};
+
+// Pierson-Moskowitz, no peak enhancement
+struct jonswapPMShape {
+	static constexpr double gamma = 1.0;
+	static constexpr double s1 = 0.07;
+	static constexpr double s2 = 0.09;
+};
+
+// log(x) usable in constant expressions: x = 2^n m with m in [0.75, 1.5),
+// log(m) = 2 atanh(z), z = (m-1)/(m+1), summed until the terms vanish
+constexpr double jonswapLogSeries(double z2, double term, int k) {
+	return k > 40 ? 0.0 : term / (2*k + 1) + jonswapLogSeries(z2, term * z2, k + 1);
+}
+
+constexpr double jonswapLogMantissa(double m) {
+	return 2.0 * jonswapLogSeries(((m - 1)/(m + 1)) * ((m - 1)/(m + 1)), (m - 1)/(m + 1), 0);
+}
+
+constexpr double jonswapConstLog(double x, int n = 0) {
+	return x >= 1.5 ? jonswapConstLog(x / 2, n + 1)
+		: x < 0.75 ? jonswapConstLog(x * 2, n - 1)
+		: n * 0.69314718055994530942 + jonswapLogMantissa(x);
+}
+
+template<class Shape>
+class jonswapFixed
+{
+public:
+	static constexpr double lng = jonswapConstLog(Shape::gamma);
+	static constexpr double k1 = 1.0 / (2 * Shape::s1 * Shape::s1);
+	static constexpr double k2 = 1.0 / (2 * Shape::s2 * Shape::s2);
+	static constexpr bool pm = Shape::gamma == 1.0;
+
+	jonswapFixed(double alpha, double wp, double g = 9.81)
+		: c(alpha * g * g), wp(wp), b(1.2 * wp * wp * wp * wp),
+		  ks{k1 / (wp * wp), k2 / (wp * wp)} {}
+
+	// Spectrum at one angular frequency, w > 0
+	double operator()(double w) const {
+		return eval(w, std::integral_constant<bool, pm>());
+	}
+
+	// Spectrum at n angular frequencies through the batch kernels
+	void operator()(const double *w, double *S, size_t n) const {
+		jonswapBatch(params(), w, S, n);
+	}
+
+	// Runtime parameters of the same spectrum, e.g. to build a jonswapEval
+	jonswapKernelParams params() const {
+		jonswapKernelParams p;
+		p.c = c;
+		p.wp = wp;
+		p.b = b;
+		p.lng = lng;
+		p.ks[0] = ks[0];
+		p.ks[1] = ks[1];
+		return p;
+	}
+
+private:
+	double c, wp, b;
+	double ks[2];
+
+	double eval(double w, std::true_type) const {
+		return jonswapShape(c, b, 0.0, w);
+	}
+	double eval(double w, std::false_type) const {
+		return jonswapShape(c, b, jonswapPeakExp(wp, lng, ks[w > wp], w), w);
+	}
+};
+
+typedef jonswapFixed<jonswapDefaultShape> jonswapDefault;
+typedef jonswapFixed<jonswapWindShape> jonswapWind;
+typedef jonswapFixed<jonswapPMShape> jonswapPM;
+
+#endif
@@ -0,0 +1,190 @@
+//
+//  jonswapIO.cpp
+//
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <utility>
+#include "jonswapIO.h"
+#include "jonswapSpec.h"
+
+static_assert(sizeof(jonswapFileHeader) == 144, "jonswapFileHeader must match the file layout");
+
+static const char MAGIC[8] = { 'J', 'O', 'N', 'S', 'W', 'A', 'P', 0 };
+
+// bytes staged before each fwrite
+static const size_t WRITE_BUFFER = 1 << 20;
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define JONSWAP_IO_SWAP 1
+#else
+#define JONSWAP_IO_SWAP 0
+#endif
+
+namespace {
+
+// little-endian output through one buffer
+class bufferedWriter {
+public:
+	explicit bufferedWriter(FILE *f) : f(f), buf(WRITE_BUFFER), used(0), ok(true) {}
+
+	void put(const void *data, size_t n, size_t word) {
+		const char *p = (const char *) data;
+		while (n > 0) {
+			size_t m = buf.size() - used < n ? buf.size() - used : n;
+			m -= m % word;
+			memcpy(&buf[used], p, m);
+			if (JONSWAP_IO_SWAP && word > 1)
+				for (size_t i = used; i < used + m; i += word)
+					for (size_t j = 0; j < word / 2; j++)
+						std::swap(buf[i + j], buf[i + word - 1 - j]);
+			used += m;
+			p += m;
+			n -= m;
+			if (used + word > buf.size())
+				flush();
+		}
+	}
+
+	bool flush() {
+		if (used && fwrite(&buf[0], 1, used, f) != used)
+			ok = false;
+		used = 0;
+		return ok;
+	}
+
+private:
+	FILE *f;
+	vector<char> buf;
+	size_t used;
+	bool ok;
+};
+
+}
+
+jonswapFileHeader jonswapMakeHeader(const jonswapSpec &spec, double depth) {
+	jonswapFileHeader h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, MAGIC, sizeof(MAGIC));
+	h.version = JONSWAP_IO_VERSION;
+	h.headerSize = sizeof(h);
+	h.alpha = spec.getAlpha();
+	h.wp = spec.getWp();
+	h.wmax = spec.getWmax();
+	h.gamma = spec.getGamma();
+	h.s1 = spec.getS1();
+	h.s2 = spec.getS2();
+	h.vel10 = spec.getVel10();
+	h.F = spec.getF();
+	h.g = spec.getG();
+	h.depth = depth;
+
+	const jonswapBins &b = spec.getBinData();
+	h.count[JONSWAP_IO_EDGES] = b.edges.size();
+	h.count[JONSWAP_IO_WC] = b.wc.size();
+	h.count[JONSWAP_IO_AMPS] = b.amps.size();
+	h.count[JONSWAP_IO_PADDLE] = b.paddleAmps.size();
+	return h;
+}
+
+bool jonswapWriteFile(const char *path, const jonswapFileHeader &h,
+		const double *const arrays[JONSWAP_IO_ARRAYS]) {
+	FILE *f = fopen(path, "wb");
+	if (!f)
+		return false;
+	setvbuf(f, NULL, _IONBF, 0);  // bufferedWriter does the buffering
+
+	bufferedWriter out(f);
+	out.put(h.magic, sizeof(h.magic), 1);
+	out.put(&h.version, sizeof(h.version), 4);
+	out.put(&h.headerSize, sizeof(h.headerSize), 4);
+	out.put(&h.alpha, 10 * sizeof(double), 8);
+	out.put(h.count, sizeof(h.count), 8);
+	for (int a = 0; a < JONSWAP_IO_ARRAYS; a++)
+		if (h.count[a])
+			out.put(arrays[a], h.count[a] * sizeof(double), 8);
+
+	bool ok = out.flush();
+	return fclose(f) == 0 && ok;
+}
+
+bool jonswapWriteFile(const char *path, const jonswapSpec &spec, const vector<double> &w,
+		const vector<double> &S, double depth) {
+	jonswapFileHeader h = jonswapMakeHeader(spec, depth);
+	h.count[JONSWAP_IO_W] = w.size();
+	h.count[JONSWAP_IO_S] = S.size();
+
+	const jonswapBins &b = spec.getBinData();
+	const double *arrays[JONSWAP_IO_ARRAYS] = {
+		w.empty() ? NULL : &w[0],
+		S.empty() ? NULL : &S[0],
+		b.edges.empty() ? NULL : &b.edges[0],
+		b.wc.empty() ? NULL : &b.wc[0],
+		b.amps.empty() ? NULL : &b.amps[0],
+		b.paddleAmps.empty() ? NULL : &b.paddleAmps[0]
+	};
+	return jonswapWriteFile(path, h, arrays);
+}
+
+jonswapMappedFile::jonswapMappedFile() : base(NULL), bytes(0) {
+	for (int a = 0; a < JONSWAP_IO_ARRAYS; a++)
+		arrays[a] = NULL;
+}
+
+jonswapMappedFile::~jonswapMappedFile() {
+	close();
+}
+
+bool jonswapMappedFile::open(const char *path) {
+	close();
+	// the arrays are used in place, so the host must be little-endian
+	if (JONSWAP_IO_SWAP)
+		return false;
+
+	int fd = ::open(path, O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(jonswapFileHeader)) {
+		::close(fd);
+		return false;
+	}
+	void *p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (p == MAP_FAILED)
+		return false;
+	base = p;
+	bytes = st.st_size;
+
+	const jonswapFileHeader &h = header();
+	size_t offset = h.headerSize;
+	if (memcmp(h.magic, MAGIC, sizeof(MAGIC)) || h.version != JONSWAP_IO_VERSION
+			|| h.headerSize < sizeof(jonswapFileHeader) || h.headerSize > bytes
+			|| h.headerSize % sizeof(double)) {
+		// past the end, bytes - offset below would wrap
+		close();
+		return false;
+	}
+	for (int a = 0; a < JONSWAP_IO_ARRAYS; a++) {
+		if (h.count[a] > (bytes - offset) / sizeof(double)) {
+			close();
+			return false;
+		}
+		arrays[a] = (const double *) ((const char *) base + offset);
+		offset += h.count[a] * sizeof(double);
+	}
+	return true;
+}
+
+void jonswapMappedFile::close() {
+	if (base)
+		munmap(base, bytes);
+	base = NULL;
+	bytes = 0;
+	for (int a = 0; a < JONSWAP_IO_ARRAYS; a++)
+		arrays[a] = NULL;
+}
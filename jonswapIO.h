@@ -0,0 +1,87 @@
+//
+//  jonswapIO.h
+//
+//  Binary file of a spectrum and its bins: a fixed 144 byte header with the
+//  spectrum parameters and the array lengths, followed by the arrays as raw
+//  little-endian doubles in jonswapArray order, without padding:
+//
+//      offset  0  char[8]   "JONSWAP\0"
+//              8  uint32    version (1)
+//             12  uint32    header size in bytes (144)
+//             16  double    alpha, wp, wmax, gamma, s1, s2, vel10, F, g, depth
+//             96  uint64    length of w, S, edges, wc, amps, paddleAmps
+//            144  double[]  the arrays
+//
+//  The writer goes through one large buffer. jonswapMappedFile maps a file
+//  read-only and hands out pointers straight into the mapping. Loaders for
+//  MATLAB (jonswapLoad.m) and NumPy (jonswap_load.py) read the same layout.
+//
+
+#ifndef JONSWAPIO_H
+#define JONSWAPIO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+using std::vector;
+
+class jonswapSpec;
+
+enum jonswapArray {
+	JONSWAP_IO_W = 0,       // frequencies S was evaluated at
+	JONSWAP_IO_S,           // S(w)
+	JONSWAP_IO_EDGES,
+	JONSWAP_IO_WC,
+	JONSWAP_IO_AMPS,
+	JONSWAP_IO_PADDLE,
+	JONSWAP_IO_ARRAYS
+};
+
+struct jonswapFileHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t headerSize;
+	double alpha, wp, wmax, gamma, s1, s2, vel10, F, g, depth;
+	uint64_t count[JONSWAP_IO_ARRAYS];
+};
+
+static const uint32_t JONSWAP_IO_VERSION = 1;
+
+// Header with the parameters of spec and the lengths of its bin arrays;
+// w and S are left empty
+jonswapFileHeader jonswapMakeHeader(const jonswapSpec &spec, double depth);
+
+// Write h and the arrays (lengths from h.count, null for empty arrays)
+bool jonswapWriteFile(const char *path, const jonswapFileHeader &h,
+		const double *const arrays[JONSWAP_IO_ARRAYS]);
+
+// spec, its bins and the sampled spectrum S(w)
+bool jonswapWriteFile(const char *path, const jonswapSpec &spec, const vector<double> &w,
+		const vector<double> &S, double depth);
+
+class jonswapMappedFile
+{
+public:
+	jonswapMappedFile();
+	~jonswapMappedFile();
+
+	// false if the file can't be mapped or isn't a valid jonswap file
+	bool open(const char *path);
+	void close();
+	bool isOpen() const { return base != NULL; }
+
+	const jonswapFileHeader &header() const { return *(const jonswapFileHeader *) base; }
+	size_t size(jonswapArray a) const { return isOpen() ? (size_t) header().count[a] : 0; }
+	const double *array(jonswapArray a) const { return isOpen() ? arrays[a] : NULL; }
+
+private:
+	void *base;
+	size_t bytes;
+	const double *arrays[JONSWAP_IO_ARRAYS];
+
+	jonswapMappedFile(const jonswapMappedFile &) = delete;
+	jonswapMappedFile &operator=(const jonswapMappedFile &) = delete;
+};
+
+#endif
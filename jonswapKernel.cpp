@@ -0,0 +1,262 @@
+//
+//  jonswapKernel.cpp
+//
+//  Kernel parameters, the scalar and NEON kernels and runtime dispatch.
+//  The AVX2 and AVX-512 kernels live in their own files so they can be
+//  built with the matching -m flags.
+//
+
+#include <math.h>
+#include <atomic>
+#include "jonswapKernel.h"
+#include "jonswapKernelImpl.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define JONSWAP_X86_KERNELS 1
+void jonswapBatchAVX2(const jonswapKernelParams &p, const double *w, double *S, size_t n);
+void jonswapBatchAVX512(const jonswapKernelParams &p, const double *w, double *S, size_t n);
+void jonswapBatchPeaksAVX2(const jonswapPeakParams &m, const double *w, double *S, size_t n);
+void jonswapBatchPeaksAVX512(const jonswapPeakParams &m, const double *w, double *S, size_t n);
+void jonswapBatchAVX2F(const jonswapKernelParams &p, const float *w, float *S, size_t n);
+void jonswapBatchAVX512F(const jonswapKernelParams &p, const float *w, float *S, size_t n);
+void jonswapBatchPeaksAVX2F(const jonswapPeakParams &m, const float *w, float *S, size_t n);
+void jonswapBatchPeaksAVX512F(const jonswapPeakParams &m, const float *w, float *S, size_t n);
+#else
+#define JONSWAP_X86_KERNELS 0
+#endif
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+
+namespace {
+
+// aarch64 always has double precision NEON, so no cpu check is needed
+struct jonswapVecNEON {
+	typedef double scalar;
+	typedef float64x2_t reg;
+	typedef uint64x2_t mask;
+	enum { width = 2 };
+
+	static reg set1(double x) { return vdupq_n_f64(x); }
+	static reg load(const double *p) { return vld1q_f64(p); }
+	static void store(double *p, reg a) { vst1q_f64(p, a); }
+	static reg add(reg a, reg b) { return vaddq_f64(a, b); }
+	static reg sub(reg a, reg b) { return vsubq_f64(a, b); }
+	static reg mul(reg a, reg b) { return vmulq_f64(a, b); }
+	static reg div(reg a, reg b) { return vdivq_f64(a, b); }
+	static reg fmadd(reg a, reg b, reg c) { return vfmaq_f64(c, a, b); }
+	static reg max(reg a, reg b) { return vmaxq_f64(a, b); }
+	static reg min(reg a, reg b) { return vminq_f64(a, b); }
+	static mask gt(reg a, reg b) { return vcgtq_f64(a, b); }
+	static mask lt(reg a, reg b) { return vcltq_f64(a, b); }
+	static reg select(mask m, reg a, reg b) { return vbslq_f64(m, a, b); }
+	static reg pow2n(reg t) {
+		return vreinterpretq_f64_s64(vshlq_n_s64(vreinterpretq_s64_f64(t), 52));
+	}
+};
+
+struct jonswapVecNEONF {
+	typedef float scalar;
+	typedef float32x4_t reg;
+	typedef uint32x4_t mask;
+	enum { width = 4 };
+
+	static reg set1(float x) { return vdupq_n_f32(x); }
+	static reg load(const float *p) { return vld1q_f32(p); }
+	static void store(float *p, reg a) { vst1q_f32(p, a); }
+	static reg add(reg a, reg b) { return vaddq_f32(a, b); }
+	static reg sub(reg a, reg b) { return vsubq_f32(a, b); }
+	static reg mul(reg a, reg b) { return vmulq_f32(a, b); }
+	static reg div(reg a, reg b) { return vdivq_f32(a, b); }
+	static reg fmadd(reg a, reg b, reg c) { return vfmaq_f32(c, a, b); }
+	static reg max(reg a, reg b) { return vmaxq_f32(a, b); }
+	static reg min(reg a, reg b) { return vminq_f32(a, b); }
+	static mask gt(reg a, reg b) { return vcgtq_f32(a, b); }
+	static mask lt(reg a, reg b) { return vcltq_f32(a, b); }
+	static reg select(mask m, reg a, reg b) { return vbslq_f32(m, a, b); }
+	static reg pow2n(reg t) {
+		return vreinterpretq_f32_s32(vshlq_n_s32(vreinterpretq_s32_f32(t), 23));
+	}
+};
+
+}
+
+static void jonswapBatchNEON(const jonswapKernelParams &p, const double *w, double *S, size_t n) {
+	jonswapBatchImpl<jonswapVecNEON>(p, w, S, n);
+}
+
+static void jonswapBatchPeaksNEON(const jonswapPeakParams &m, const double *w, double *S, size_t n) {
+	jonswapBatchPeaksImpl<jonswapVecNEON>(m, w, S, n);
+}
+
+static void jonswapBatchNEONF(const jonswapKernelParams &p, const float *w, float *S, size_t n) {
+	jonswapBatchImpl<jonswapVecNEONF>(p, w, S, n);
+}
+
+static void jonswapBatchPeaksNEONF(const jonswapPeakParams &m, const float *w, float *S, size_t n) {
+	jonswapBatchPeaksImpl<jonswapVecNEONF>(m, w, S, n);
+}
+#endif
+
+static void jonswapBatchScalar(const jonswapKernelParams &p, const double *w, double *S, size_t n) {
+	jonswapBatchImpl<jonswapVecScalar>(p, w, S, n);
+}
+
+static void jonswapBatchPeaksScalar(const jonswapPeakParams &m, const double *w, double *S, size_t n) {
+	jonswapBatchPeaksImpl<jonswapVecScalar>(m, w, S, n);
+}
+
+static void jonswapBatchScalarF(const jonswapKernelParams &p, const float *w, float *S, size_t n) {
+	jonswapBatchImpl<jonswapVecScalarF>(p, w, S, n);
+}
+
+static void jonswapBatchPeaksScalarF(const jonswapPeakParams &m, const float *w, float *S, size_t n) {
+	jonswapBatchPeaksImpl<jonswapVecScalarF>(m, w, S, n);
+}
+
+// entry points of one kernel
+struct jonswapKernelFns {
+	void (*batch)(const jonswapKernelParams &, const double *, double *, size_t);
+	void (*peaks)(const jonswapPeakParams &, const double *, double *, size_t);
+	void (*batchF)(const jonswapKernelParams &, const float *, float *, size_t);
+	void (*peaksF)(const jonswapPeakParams &, const float *, float *, size_t);
+};
+
+static const jonswapKernelFns *kernelFns(jonswapKernelType type) {
+	static const jonswapKernelFns scalar = {
+		jonswapBatchScalar, jonswapBatchPeaksScalar, jonswapBatchScalarF, jonswapBatchPeaksScalarF
+	};
+#if JONSWAP_X86_KERNELS
+	static const jonswapKernelFns avx2 = {
+		jonswapBatchAVX2, jonswapBatchPeaksAVX2, jonswapBatchAVX2F, jonswapBatchPeaksAVX2F
+	};
+	static const jonswapKernelFns avx512 = {
+		jonswapBatchAVX512, jonswapBatchPeaksAVX512, jonswapBatchAVX512F, jonswapBatchPeaksAVX512F
+	};
+#endif
+#if defined(__aarch64__)
+	static const jonswapKernelFns neon = {
+		jonswapBatchNEON, jonswapBatchPeaksNEON, jonswapBatchNEONF, jonswapBatchPeaksNEONF
+	};
+#endif
+	switch (type) {
+	case JONSWAP_KERNEL_SCALAR:
+		return &scalar;
+#if JONSWAP_X86_KERNELS
+	case JONSWAP_KERNEL_AVX2:
+		return &avx2;
+	case JONSWAP_KERNEL_AVX512:
+		return &avx512;
+#endif
+#if defined(__aarch64__)
+	case JONSWAP_KERNEL_NEON:
+		return &neon;
+#endif
+	default:
+		return 0;
+	}
+}
+
+bool jonswapKernelSupported(jonswapKernelType type) {
+	switch (type) {
+	case JONSWAP_KERNEL_AUTO:
+	case JONSWAP_KERNEL_SCALAR:
+		return true;
+#if JONSWAP_X86_KERNELS
+	case JONSWAP_KERNEL_AVX2:
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+	case JONSWAP_KERNEL_AVX512:
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx512f");
+#endif
+#if defined(__aarch64__)
+	case JONSWAP_KERNEL_NEON:
+		return true;
+#endif
+	default:
+		return false;
+	}
+}
+
+static jonswapKernelType bestKernel() {
+	const jonswapKernelType order[] = {
+		JONSWAP_KERNEL_AVX512, JONSWAP_KERNEL_AVX2, JONSWAP_KERNEL_NEON
+	};
+	for (size_t i = 0; i < sizeof(order)/sizeof(order[0]); i++) {
+		if (jonswapKernelSupported(order[i]))
+			return order[i];
+	}
+	return JONSWAP_KERNEL_SCALAR;
+}
+
+static std::atomic<jonswapKernelType> &activeKernel() {
+	static std::atomic<jonswapKernelType> active(bestKernel());
+	return active;
+}
+
+bool jonswapSetKernel(jonswapKernelType type) {
+	if (type == JONSWAP_KERNEL_AUTO)
+		type = bestKernel();
+	if (!jonswapKernelSupported(type))
+		return false;
+	activeKernel().store(type);
+	return true;
+}
+
+jonswapKernelType jonswapGetKernel() {
+	return activeKernel().load(std::memory_order_relaxed);
+}
+
+const char *jonswapKernelName(jonswapKernelType type) {
+	switch (type) {
+	case JONSWAP_KERNEL_AUTO:   return "auto";
+	case JONSWAP_KERNEL_SCALAR: return "scalar";
+	case JONSWAP_KERNEL_AVX2:   return "avx2";
+	case JONSWAP_KERNEL_AVX512: return "avx512";
+	case JONSWAP_KERNEL_NEON:   return "neon";
+	}
+	return "unknown";
+}
+
+jonswapKernelParams jonswapMakeKernelParams(double alpha, double wp, double gamma,
+		double s1, double s2, double g) {
+	jonswapKernelParams p;
+	p.c = alpha * g * g;
+	p.wp = wp;
+	p.b = 1.2 * wp * wp * wp * wp;
+	p.lng = log(gamma);
+	p.ks[0] = 1.0 / (2.0 * s1 * s1 * wp * wp);
+	p.ks[1] = 1.0 / (2.0 * s2 * s2 * wp * wp);
+	return p;
+}
+
+void jonswapBatch(const jonswapKernelParams &p, const double *w, double *S, size_t n) {
+	kernelFns(jonswapGetKernel())->batch(p, w, S, n);
+}
+
+void jonswapBatch(const jonswapKernelParams &p, const float *w, float *S, size_t n) {
+	kernelFns(jonswapGetKernel())->batchF(p, w, S, n);
+}
+
+bool jonswapSetPeak(jonswapPeakParams &m, size_t k, const jonswapKernelParams &p) {
+	if (k > m.n || k >= JONSWAP_MAX_PEAKS)
+		return false;
+	m.c[k] = p.c;
+	m.wp[k] = p.wp;
+	m.b[k] = p.b;
+	m.lng[k] = p.lng;
+	m.ks0[k] = p.ks[0];
+	m.ks1[k] = p.ks[1];
+	if (k == m.n)
+		m.n++;
+	return true;
+}
+
+void jonswapBatchPeaks(const jonswapPeakParams &m, const double *w, double *S, size_t n) {
+	kernelFns(jonswapGetKernel())->peaks(m, w, S, n);
+}
+
+void jonswapBatchPeaks(const jonswapPeakParams &m, const float *w, float *S, size_t n) {
+	kernelFns(jonswapGetKernel())->peaksF(m, w, S, n);
+}
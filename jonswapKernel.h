@@ -0,0 +1,113 @@
+//
+//  jonswapKernel.h
+//
+//  Batch evaluation kernels for the jonswap spectrum.
+//
+//  The spectrum is rewritten so that a batch only needs two exponentials and
+//  no pow() per point:
+//
+//   S_j (omega) = c u^5 * exp[-b u^4 + ln(gamma) * r],  u = 1/omega
+//             r = exp[-(omega - omega_p)^2 * ks]
+//
+//  with c = alpha g^2, b = 1.2 omega_p^4 and ks = 1/(2 sigma^2 omega_p^2).
+//  The SIMD kernel is picked once at startup from what the cpu supports.
+//
+
+#ifndef JONSWAPKERNEL_H
+#define JONSWAPKERNEL_H
+
+#include <stddef.h>
+#include <math.h>
+
+// Invariants of a spectrum, computed once and shared by every kernel
+struct jonswapKernelParams {
+	double c;      // alpha g^2
+	double wp;     // peak angular frequency
+	double b;      // 1.2 wp^4
+	double lng;    // log(gamma)
+	double ks[2];  // 1/(2 s^2 wp^2), [0] for w <= wp, [1] for w > wp
+};
+
+enum jonswapKernelType {
+	JONSWAP_KERNEL_AUTO = 0,
+	JONSWAP_KERNEL_SCALAR,
+	JONSWAP_KERNEL_AVX2,
+	JONSWAP_KERNEL_AVX512,
+	JONSWAP_KERNEL_NEON
+};
+
+// Peak enhancement exponent ln(gamma) * r for one frequency
+inline double jonswapPeakExp(double wp, double lng, double ks, double w) {
+	double dw = w - wp;
+	return lng * exp(-dw * dw * ks);
+}
+
+// c u^5 exp[peak - b u^4]; with peak = 0 this is the Pierson-Moskowitz shape
+inline double jonswapShape(double c, double b, double peak, double w) {
+	double u = 1.0 / w;
+	double u2 = u * u;
+	double u4 = u2 * u2;
+	return c * u4 * u * exp(peak - b * u4);
+}
+
+// Scalar spectrum at w > 0. This is the one scalar definition of the
+// formula; jonswapSpec::getamp and jonswapEval both evaluate it.
+inline double jonswapFormula(const jonswapKernelParams &p, double w) {
+	return jonswapShape(p.c, p.b, jonswapPeakExp(p.wp, p.lng, p.ks[w > p.wp], w), w);
+}
+
+jonswapKernelParams jonswapMakeKernelParams(double alpha, double wp, double gamma,
+		double s1, double s2, double g);
+
+// Superposed spectra (wind sea + swell, ...) as one array per invariant.
+// The kernels compute 1/w and its powers once and add the peaks with one
+// exp pair each.
+#define JONSWAP_MAX_PEAKS 8
+
+struct jonswapPeakParams {
+	size_t n;
+	double c[JONSWAP_MAX_PEAKS], wp[JONSWAP_MAX_PEAKS], b[JONSWAP_MAX_PEAKS];
+	double lng[JONSWAP_MAX_PEAKS], ks0[JONSWAP_MAX_PEAKS], ks1[JONSWAP_MAX_PEAKS];
+};
+
+// Store p as peak k (k <= n, k == n appends); false when full
+bool jonswapSetPeak(jonswapPeakParams &m, size_t k, const jonswapKernelParams &p);
+
+// Scalar sum of the peaks at w > 0
+inline double jonswapPeaksFormula(const jonswapPeakParams &m, double w) {
+	double u = 1.0 / w;
+	double u2 = u * u;
+	double u4 = u2 * u2;
+	double sum = 0;
+	for (size_t k = 0; k < m.n; k++) {
+		double dw = w - m.wp[k];
+		double r = exp(-dw * dw * (w > m.wp[k] ? m.ks1[k] : m.ks0[k]));
+		sum += m.c[k] * exp(m.lng[k] * r - m.b[k] * u4);
+	}
+	return u4 * u * sum;
+}
+
+// Evaluate the spectrum at n points of w into S (no allocation).
+// Points with w <= 0 yield 0, the limit of the spectrum as w -> 0.
+void jonswapBatch(const jonswapKernelParams &p, const double *w, double *S, size_t n);
+
+// Same for superposed peaks, through the same kernel
+void jonswapBatchPeaks(const jonswapPeakParams &m, const double *w, double *S, size_t n);
+
+// Float versions, twice the lanes per register and half the memory
+// traffic. The invariants are rounded to float and the exp() is a float
+// polynomial. On the jonswap_validate corpus (batchf, tailf) the relative
+// error is below 6e-6 where S is at least 1e-6 of its peak and below 3e-5
+// down to 1e-30 of it, where the exp() argument approaches -87 and its
+// float rounding shows; values below FLT_MIN are 0.
+void jonswapBatch(const jonswapKernelParams &p, const float *w, float *S, size_t n);
+void jonswapBatchPeaks(const jonswapPeakParams &m, const float *w, float *S, size_t n);
+
+// Force a specific kernel; returns false if this cpu can't run it.
+// JONSWAP_KERNEL_AUTO restores the best supported kernel.
+bool jonswapSetKernel(jonswapKernelType type);
+jonswapKernelType jonswapGetKernel();
+bool jonswapKernelSupported(jonswapKernelType type);
+const char *jonswapKernelName(jonswapKernelType type);
+
+#endif
@@ -0,0 +1,82 @@
+//
+//  jonswapKernelAVX2.cpp
+//
+//  AVX2 + FMA batch kernels, 4 doubles or 8 floats per register.
+//  Built with -mavx2 -mfma (see makefile); only called after a cpu check.
+//
+
+#include "jonswapKernel.h"
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#include "jonswapKernelImpl.h"
+
+namespace {
+
+struct jonswapVecAVX2 {
+	typedef double scalar;
+	typedef __m256d reg;
+	typedef __m256d mask;
+	enum { width = 4 };
+
+	static reg set1(double x) { return _mm256_set1_pd(x); }
+	static reg load(const double *p) { return _mm256_loadu_pd(p); }
+	static void store(double *p, reg a) { _mm256_storeu_pd(p, a); }
+	static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+	static reg sub(reg a, reg b) { return _mm256_sub_pd(a, b); }
+	static reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+	static reg div(reg a, reg b) { return _mm256_div_pd(a, b); }
+	static reg fmadd(reg a, reg b, reg c) { return _mm256_fmadd_pd(a, b, c); }
+	static reg max(reg a, reg b) { return _mm256_max_pd(a, b); }
+	static reg min(reg a, reg b) { return _mm256_min_pd(a, b); }
+	static mask gt(reg a, reg b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+	static mask lt(reg a, reg b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+	static reg select(mask m, reg a, reg b) { return _mm256_blendv_pd(b, a, m); }
+	static reg pow2n(reg t) {
+		return _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_castpd_si256(t), 52));
+	}
+};
+
+struct jonswapVecAVX2F {
+	typedef float scalar;
+	typedef __m256 reg;
+	typedef __m256 mask;
+	enum { width = 8 };
+
+	static reg set1(float x) { return _mm256_set1_ps(x); }
+	static reg load(const float *p) { return _mm256_loadu_ps(p); }
+	static void store(float *p, reg a) { _mm256_storeu_ps(p, a); }
+	static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+	static reg sub(reg a, reg b) { return _mm256_sub_ps(a, b); }
+	static reg mul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+	static reg div(reg a, reg b) { return _mm256_div_ps(a, b); }
+	static reg fmadd(reg a, reg b, reg c) { return _mm256_fmadd_ps(a, b, c); }
+	static reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+	static reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+	static mask gt(reg a, reg b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+	static mask lt(reg a, reg b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+	static reg select(mask m, reg a, reg b) { return _mm256_blendv_ps(b, a, m); }
+	static reg pow2n(reg t) {
+		return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_castps_si256(t), 23));
+	}
+};
+
+}
+
+void jonswapBatchAVX2(const jonswapKernelParams &p, const double *w, double *S, size_t n) {
+	jonswapBatchImpl<jonswapVecAVX2>(p, w, S, n);
+}
+
+void jonswapBatchPeaksAVX2(const jonswapPeakParams &m, const double *w, double *S, size_t n) {
+	jonswapBatchPeaksImpl<jonswapVecAVX2>(m, w, S, n);
+}
+
+void jonswapBatchAVX2F(const jonswapKernelParams &p, const float *w, float *S, size_t n) {
+	jonswapBatchImpl<jonswapVecAVX2F>(p, w, S, n);
+}
+
+void jonswapBatchPeaksAVX2F(const jonswapPeakParams &m, const float *w, float *S, size_t n) {
+	jonswapBatchPeaksImpl<jonswapVecAVX2F>(m, w, S, n);
+}
+
+#endif
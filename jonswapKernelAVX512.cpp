@@ -0,0 +1,82 @@
+//
+//  jonswapKernelAVX512.cpp
+//
+//  AVX-512F batch kernels, 8 doubles or 16 floats per register.
+//  Built with -mavx512f (see makefile); only called after a cpu check.
+//
+
+#include "jonswapKernel.h"
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#include "jonswapKernelImpl.h"
+
+namespace {
+
+struct jonswapVecAVX512 {
+	typedef double scalar;
+	typedef __m512d reg;
+	typedef __mmask8 mask;
+	enum { width = 8 };
+
+	static reg set1(double x) { return _mm512_set1_pd(x); }
+	static reg load(const double *p) { return _mm512_loadu_pd(p); }
+	static void store(double *p, reg a) { _mm512_storeu_pd(p, a); }
+	static reg add(reg a, reg b) { return _mm512_add_pd(a, b); }
+	static reg sub(reg a, reg b) { return _mm512_sub_pd(a, b); }
+	static reg mul(reg a, reg b) { return _mm512_mul_pd(a, b); }
+	static reg div(reg a, reg b) { return _mm512_div_pd(a, b); }
+	static reg fmadd(reg a, reg b, reg c) { return _mm512_fmadd_pd(a, b, c); }
+	static reg max(reg a, reg b) { return _mm512_max_pd(a, b); }
+	static reg min(reg a, reg b) { return _mm512_min_pd(a, b); }
+	static mask gt(reg a, reg b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+	static mask lt(reg a, reg b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+	static reg select(mask m, reg a, reg b) { return _mm512_mask_blend_pd(m, b, a); }
+	static reg pow2n(reg t) {
+		return _mm512_castsi512_pd(_mm512_slli_epi64(_mm512_castpd_si512(t), 52));
+	}
+};
+
+struct jonswapVecAVX512F {
+	typedef float scalar;
+	typedef __m512 reg;
+	typedef __mmask16 mask;
+	enum { width = 16 };
+
+	static reg set1(float x) { return _mm512_set1_ps(x); }
+	static reg load(const float *p) { return _mm512_loadu_ps(p); }
+	static void store(float *p, reg a) { _mm512_storeu_ps(p, a); }
+	static reg add(reg a, reg b) { return _mm512_add_ps(a, b); }
+	static reg sub(reg a, reg b) { return _mm512_sub_ps(a, b); }
+	static reg mul(reg a, reg b) { return _mm512_mul_ps(a, b); }
+	static reg div(reg a, reg b) { return _mm512_div_ps(a, b); }
+	static reg fmadd(reg a, reg b, reg c) { return _mm512_fmadd_ps(a, b, c); }
+	static reg max(reg a, reg b) { return _mm512_max_ps(a, b); }
+	static reg min(reg a, reg b) { return _mm512_min_ps(a, b); }
+	static mask gt(reg a, reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+	static mask lt(reg a, reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+	static reg select(mask m, reg a, reg b) { return _mm512_mask_blend_ps(m, b, a); }
+	static reg pow2n(reg t) {
+		return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_castps_si512(t), 23));
+	}
+};
+
+}
+
+void jonswapBatchAVX512(const jonswapKernelParams &p, const double *w, double *S, size_t n) {
+	jonswapBatchImpl<jonswapVecAVX512>(p, w, S, n);
+}
+
+void jonswapBatchPeaksAVX512(const jonswapPeakParams &m, const double *w, double *S, size_t n) {
+	jonswapBatchPeaksImpl<jonswapVecAVX512>(m, w, S, n);
+}
+
+void jonswapBatchAVX512F(const jonswapKernelParams &p, const float *w, float *S, size_t n) {
+	jonswapBatchImpl<jonswapVecAVX512F>(p, w, S, n);
+}
+
+void jonswapBatchPeaksAVX512F(const jonswapPeakParams &m, const float *w, float *S, size_t n) {
+	jonswapBatchPeaksImpl<jonswapVecAVX512F>(m, w, S, n);
+}
+
+#endif
@@ -0,0 +1,226 @@
+//
+//  jonswapKernelImpl.h
+//
+//  Generic body of the batch kernels, written against a small vector
+//  traits struct V (scalar, reg, mask, width, load/store, arithmetic,
+//  select and pow2n), with V::scalar double or float. Each kernel translation unit includes this with its own traits
+//  and compiler flags, so everything here has internal linkage: code built
+//  with -mavx2 must never be merged with the baseline build of the same
+//  inline function.
+//
+
+#ifndef JONSWAPKERNELIMPL_H
+#define JONSWAPKERNELIMPL_H
+
+#include <string.h>
+#include <stdint.h>
+#include "jonswapKernel.h"
+
+namespace {
+
+// Plain doubles, used for the scalar kernel and for the tail of every batch
+struct jonswapVecScalar {
+	typedef double scalar;
+	typedef double reg;
+	typedef bool mask;
+	enum { width = 1 };
+
+	static reg set1(double x) { return x; }
+	static reg load(const double *p) { return *p; }
+	static void store(double *p, reg a) { *p = a; }
+	static reg add(reg a, reg b) { return a + b; }
+	static reg sub(reg a, reg b) { return a - b; }
+	static reg mul(reg a, reg b) { return a * b; }
+	static reg div(reg a, reg b) { return a / b; }
+	static reg fmadd(reg a, reg b, reg c) { return a * b + c; }
+	static reg max(reg a, reg b) { return a > b ? a : b; }
+	static reg min(reg a, reg b) { return a < b ? a : b; }
+	static mask gt(reg a, reg b) { return a > b; }
+	static mask lt(reg a, reg b) { return a < b; }
+	static reg select(mask m, reg a, reg b) { return m ? a : b; }
+	static reg pow2n(reg t) {
+		uint64_t bits;
+		memcpy(&bits, &t, sizeof(bits));
+		bits <<= 52;
+		memcpy(&t, &bits, sizeof(t));
+		return t;
+	}
+};
+
+// Plain floats, the same for the float kernels
+struct jonswapVecScalarF {
+	typedef float scalar;
+	typedef float reg;
+	typedef bool mask;
+	enum { width = 1 };
+
+	static reg set1(float x) { return x; }
+	static reg load(const float *p) { return *p; }
+	static void store(float *p, reg a) { *p = a; }
+	static reg add(reg a, reg b) { return a + b; }
+	static reg sub(reg a, reg b) { return a - b; }
+	static reg mul(reg a, reg b) { return a * b; }
+	static reg div(reg a, reg b) { return a / b; }
+	static reg fmadd(reg a, reg b, reg c) { return a * b + c; }
+	static reg max(reg a, reg b) { return a > b ? a : b; }
+	static reg min(reg a, reg b) { return a < b ? a : b; }
+	static mask gt(reg a, reg b) { return a > b; }
+	static mask lt(reg a, reg b) { return a < b; }
+	static reg select(mask m, reg a, reg b) { return m ? a : b; }
+	static reg pow2n(reg t) {
+		uint32_t bits;
+		memcpy(&bits, &t, sizeof(bits));
+		bits <<= 23;
+		memcpy(&t, &bits, sizeof(t));
+		return t;
+	}
+};
+
+// scalar traits for the tail of a batch of T
+template<class T> struct jonswapTailVec;
+template<> struct jonswapTailVec<double> { typedef jonswapVecScalar type; };
+template<> struct jonswapTailVec<float> { typedef jonswapVecScalarF type; };
+
+// exp(x) by Cody-Waite reduction x = n ln2 + r, |r| <= ln2/2, and a degree 13
+// Taylor polynomial (truncation error < 5e-18), so the result is within a
+// couple of ulp of libm. Results below DBL_MIN are flushed to 0, which is far
+// below anything the spectrum cares about.
+template<class V>
+inline typename V::reg jonswapVexpOf(typename V::reg x, double) {
+	typedef typename V::reg reg;
+	const double lo = -708.3964185322641;    // log(DBL_MIN)
+	const double hi = 709.0;
+	const double round = 6755399441055744.0 + 1023.0; // 1.5*2^52 + exponent bias
+
+	reg xc = V::min(V::max(x, V::set1(lo)), V::set1(hi));
+	reg t = V::fmadd(xc, V::set1(1.4426950408889634), V::set1(round));
+	reg n = V::sub(t, V::set1(round));
+	reg r = V::fmadd(n, V::set1(-6.93147180369123816490e-01), xc);
+	r = V::fmadd(n, V::set1(-1.90821492927058770002e-10), r);
+
+	reg p = V::set1(1.0 / 6227020800.0);
+	p = V::fmadd(p, r, V::set1(1.0 / 479001600.0));
+	p = V::fmadd(p, r, V::set1(1.0 / 39916800.0));
+	p = V::fmadd(p, r, V::set1(1.0 / 3628800.0));
+	p = V::fmadd(p, r, V::set1(1.0 / 362880.0));
+	p = V::fmadd(p, r, V::set1(1.0 / 40320.0));
+	p = V::fmadd(p, r, V::set1(1.0 / 5040.0));
+	p = V::fmadd(p, r, V::set1(1.0 / 720.0));
+	p = V::fmadd(p, r, V::set1(1.0 / 120.0));
+	p = V::fmadd(p, r, V::set1(1.0 / 24.0));
+	p = V::fmadd(p, r, V::set1(1.0 / 6.0));
+	p = V::fmadd(p, r, V::set1(0.5));
+	p = V::fmadd(p, r, V::set1(1.0));
+	p = V::fmadd(p, r, V::set1(1.0));
+
+	// low bits of t hold n + 1023, shift them into the exponent field
+	reg res = V::mul(p, V::pow2n(t));
+	return V::select(V::lt(x, V::set1(lo)), V::set1(0.0), res);
+}
+
+// Float exp, same reduction with a two part ln2 and the degree 7 minimax
+// polynomial of Cephes expf (about 1 ulp); flushed to 0 below FLT_MIN
+template<class V>
+inline typename V::reg jonswapVexpOf(typename V::reg x, float) {
+	typedef typename V::reg reg;
+	const float lo = -87.336544f;            // log(FLT_MIN)
+	const float hi = 88.0f;
+	const float round = 12582912.0f + 127.0f; // 1.5*2^23 + exponent bias
+
+	reg xc = V::min(V::max(x, V::set1(lo)), V::set1(hi));
+	reg t = V::fmadd(xc, V::set1(1.44269504f), V::set1(round));
+	reg n = V::sub(t, V::set1(round));
+	reg r = V::fmadd(n, V::set1(-0.693359375f), xc);
+	r = V::fmadd(n, V::set1(2.12194440e-4f), r);
+
+	reg p = V::set1(1.9875691500e-4f);
+	p = V::fmadd(p, r, V::set1(1.3981999507e-3f));
+	p = V::fmadd(p, r, V::set1(8.3334519073e-3f));
+	p = V::fmadd(p, r, V::set1(4.1665795894e-2f));
+	p = V::fmadd(p, r, V::set1(1.6666665459e-1f));
+	p = V::fmadd(p, r, V::set1(5.0000001201e-1f));
+	p = V::fmadd(p, r, V::set1(1.0f));
+	p = V::fmadd(p, r, V::set1(1.0f));
+
+	reg res = V::mul(p, V::pow2n(t));
+	return V::select(V::lt(x, V::set1(lo)), V::set1(0.0f), res);
+}
+
+template<class V>
+inline typename V::reg jonswapVexp(typename V::reg x) {
+	return jonswapVexpOf<V>(x, typename V::scalar());
+}
+
+// S(w) for one register of frequencies
+template<class V>
+inline typename V::reg jonswapVspec(const jonswapKernelParams &p, typename V::reg w) {
+	typedef typename V::reg reg;
+	const reg zero = V::set1(0.0);
+
+	reg u = V::div(V::set1(1.0), w);
+	reg u2 = V::mul(u, u);
+	reg u4 = V::mul(u2, u2);
+	reg u5 = V::mul(u4, u);
+
+	reg dw = V::sub(w, V::set1(p.wp));
+	reg ks = V::select(V::gt(w, V::set1(p.wp)), V::set1(-p.ks[1]), V::set1(-p.ks[0]));
+	reg r = jonswapVexp<V>(V::mul(V::mul(dw, dw), ks));
+
+	reg e = jonswapVexp<V>(V::fmadd(V::set1(p.lng), r, V::mul(V::set1(-p.b), u4)));
+	reg S = V::mul(V::mul(V::set1(p.c), u5), e);
+
+	// e == 0 also covers w -> 0, where u^5 may have overflowed
+	S = V::select(V::gt(e, zero), S, zero);
+	return V::select(V::gt(w, zero), S, zero);
+}
+
+// Sum of the peaks of m for one register of frequencies, sharing u^4, u^5
+template<class V>
+inline typename V::reg jonswapVpeaks(const jonswapPeakParams &m, typename V::reg w) {
+	typedef typename V::reg reg;
+	const reg zero = V::set1(0.0);
+
+	reg u = V::div(V::set1(1.0), w);
+	reg u2 = V::mul(u, u);
+	reg u4 = V::mul(u2, u2);
+	reg u5 = V::mul(u4, u);
+
+	reg sum = zero;
+	for (size_t k = 0; k < m.n; k++) {
+		reg dw = V::sub(w, V::set1(m.wp[k]));
+		reg ks = V::select(V::gt(w, V::set1(m.wp[k])), V::set1(-m.ks1[k]), V::set1(-m.ks0[k]));
+		reg r = jonswapVexp<V>(V::mul(V::mul(dw, dw), ks));
+		reg e = jonswapVexp<V>(V::fmadd(V::set1(m.lng[k]), r, V::mul(V::set1(-m.b[k]), u4)));
+		sum = V::fmadd(V::set1(m.c[k]), e, sum);
+	}
+
+	reg S = V::mul(u5, sum);
+	S = V::select(V::gt(sum, zero), S, zero);
+	return V::select(V::gt(w, zero), S, zero);
+}
+
+template<class V>
+void jonswapBatchPeaksImpl(const jonswapPeakParams &m, const typename V::scalar *w,
+		typename V::scalar *S, size_t n) {
+	typedef typename jonswapTailVec<typename V::scalar>::type tail;
+	size_t i = 0;
+	for (; i + V::width <= n; i += V::width)
+		V::store(S + i, jonswapVpeaks<V>(m, V::load(w + i)));
+	for (; i < n; ++i)
+		S[i] = jonswapVpeaks<tail>(m, w[i]);
+}
+
+template<class V>
+void jonswapBatchImpl(const jonswapKernelParams &p, const typename V::scalar *w,
+		typename V::scalar *S, size_t n) {
+	typedef typename jonswapTailVec<typename V::scalar>::type tail;
+	size_t i = 0;
+	for (; i + V::width <= n; i += V::width)
+		V::store(S + i, jonswapVspec<V>(p, V::load(w + i)));
+	for (; i < n; ++i)
+		S[i] = jonswapVspec<tail>(p, w[i]);
+}
+
+}
+
+#endif
@@ -0,0 +1,96 @@
+//
+//  jonswapLive.cpp
+//
+
+#include <math.h>
+#include <string.h>
+#include "jonswapLive.h"
+#include "jonswapPipeline.h"
+
+jonswapLive::jonswapLive(double fs, size_t chunk, size_t fadeChunks)
+	: fs(fs), chunk(chunk ? chunk : 1), pending(NULL), retired(NULL), nswaps(0), pos(0),
+	  cur(NULL), next(NULL), done(NULL), fadePos(0), inChunk(this->chunk) {
+	size_t fade = (fadeChunks ? fadeChunks : 1) * this->chunk;
+	gain.resize(fade);
+	for (size_t i = 0; i < fade; i++)
+		gain[i] = 0.5 - 0.5 * cos(M_PI * (i + 1) / fade);
+	scratch.resize(this->chunk);
+}
+
+jonswapLive::~jonswapLive() {
+	delete pending.exchange(NULL);
+	delete retired.exchange(NULL);
+	delete cur;
+	delete next;
+	delete done;
+}
+
+std::unique_ptr<jonswapLiveConfig> jonswapLive::prepare(const jonswapSpec &spec, int nbins,
+		int nmems, double depth, uint64_t seed) const {
+	std::unique_ptr<jonswapLiveConfig> c(new jonswapLiveConfig(spec, fs, chunk));
+	jonswapPipeline p(spec, seed);
+	p.setPaddleModel(spec.getPaddleModel());
+	p.run(nbins, nmems, depth, c->bins);
+	// phases from their own stream: the edges took the first draws of
+	// jonswapRng(seed), and reusing them would tie each phase to its edge
+	c->synth.setComponents(c->bins, jonswapRng::streamSeed(seed, 1));
+	return c;
+}
+
+void jonswapLive::publish(std::unique_ptr<jonswapLiveConfig> c) {
+	reclaim();
+	delete pending.exchange(c.release(), std::memory_order_acq_rel);
+}
+
+void jonswapLive::reclaim() {
+	delete retired.exchange(NULL, std::memory_order_acq_rel);
+}
+
+// Chunk boundary: end a finished fade, hand on what faded out, take the
+// next configuration
+void jonswapLive::boundary() {
+	inChunk = 0;
+	if (next && fadePos >= gain.size()) {
+		done = cur;
+		cur = next;
+		next = NULL;
+	}
+	if (done) {
+		jonswapLiveConfig *empty = NULL;
+		if (!retired.compare_exchange_strong(empty, done, std::memory_order_acq_rel))
+			return;
+		done = NULL;
+	}
+	if (!next) {
+		next = pending.exchange(NULL, std::memory_order_acq_rel);
+		if (next) {
+			fadePos = 0;
+			nswaps.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+}
+
+void jonswapLive::generate(double *out, size_t n) {
+	while (n > 0) {
+		if (inChunk == chunk)
+			boundary();
+		size_t m = chunk - inChunk < n ? chunk - inChunk : n;
+
+		if (cur)
+			cur->synth.generate(out, m);
+		else
+			memset(out, 0, m * sizeof(double));
+		if (next) {
+			next->synth.generate(&scratch[0], m);
+			for (size_t i = 0; i < m; i++) {
+				double g = fadePos < gain.size() ? gain[fadePos++] : 1.0;
+				out[i] += g * (scratch[i] - out[i]);
+			}
+		}
+		inChunk += m;
+		// only this thread writes pos, so no read-modify-write
+		pos.store(pos.load(std::memory_order_relaxed) + m, std::memory_order_relaxed);
+		out += m;
+		n -= m;
+	}
+}
@@ -0,0 +1,106 @@
+//
+//  jonswapLive.h
+//
+//  Live sea state changes for a real-time control loop. A configuration
+//  (compiled spectrum, bins with paddle amps and a jonswapSynth built from
+//  them) is prepared completely on a background thread and published; the
+//  real-time thread picks it up at the next chunk boundary and cross-fades
+//  from the old stroke signal to the new one with a raised cosine.
+//
+//  Hand-over is by ownership, through two atomic pointer slots:
+//
+//      pending  - written by publish(), taken by the real-time thread with
+//                 an exchange, so a configuration is either still the
+//                 publisher's or already the real-time thread's
+//      retired  - a configuration that has faded out, left there by the
+//                 real-time thread and deleted by the next publish() or
+//                 reclaim()
+//
+//  Only the real-time thread touches the playing configurations, so no
+//  epoch bookkeeping is needed: the one shared object is the pointer. The
+//  real-time path takes no lock, allocates and frees nothing; while the
+//  retired slot is still full it keeps playing and takes the next pending
+//  configuration once the slot has been drained. A configuration that is
+//  replaced in pending before the real-time thread saw it is deleted by
+//  publish().
+//
+//  A new configuration starts at its own t = 0, with its phases from its
+//  seed; the fade covers the phase jump. With JONSWAP_PROFILE on, the first
+//  generate() on a thread registers its profile record, which allocates.
+//
+
+#ifndef JONSWAPLIVE_H
+#define JONSWAPLIVE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "jonswapSpec.h"
+#include "jonswapEval.h"
+#include "jonswapSynth.h"
+
+using std::vector;
+
+struct jonswapLiveConfig {
+	jonswapEval eval;
+	jonswapBins bins;
+	jonswapSynth synth;
+
+	jonswapLiveConfig(const jonswapSpec &spec, double fs, size_t chunk)
+		: eval(spec), synth(fs, chunk) {}
+};
+
+class jonswapLive
+{
+public:
+	// fs in samples per second, chunk as jonswapSynth; a swap fades over
+	// fadeChunks chunks (at least one)
+	explicit jonswapLive(double fs, size_t chunk = 1024, size_t fadeChunks = 1);
+	~jonswapLive();
+
+	// Background thread: bins, amps and paddle amps of spec through a
+	// jonswapPipeline (with spec's paddle model) and the synth built from
+	// them; jitter from seed, phases from jonswapRng::stream(seed, 1)
+	std::unique_ptr<jonswapLiveConfig> prepare(const jonswapSpec &spec, int nbins, int nmems,
+			double depth, uint64_t seed) const;
+
+	// Background thread: make c the next configuration. Deletes a retired
+	// one and one still pending. One publisher at a time.
+	void publish(std::unique_ptr<jonswapLiveConfig> c);
+
+	// Background thread: delete a retired configuration, if any
+	void reclaim();
+
+	// Real-time thread: next n samples into out; silence until the first
+	// configuration has arrived, which fades in
+	void generate(double *out, size_t n);
+
+	// samples generated, configurations taken over; any thread
+	uint64_t position() const { return pos.load(std::memory_order_relaxed); }
+	uint64_t swaps() const { return nswaps.load(std::memory_order_relaxed); }
+	// real-time thread only
+	bool fading() const { return next != NULL; }
+
+	double rate() const { return fs; }
+	size_t chunkSize() const { return chunk; }
+
+private:
+	double fs;
+	size_t chunk;
+	vector<double> gain;     // fade in gains, one per sample of the fade
+	vector<double> scratch;  // one chunk of the incoming signal
+
+	std::atomic<jonswapLiveConfig *> pending, retired;
+	std::atomic<uint64_t> nswaps, pos;
+
+	// real-time thread state
+	jonswapLiveConfig *cur, *next, *done;
+	size_t fadePos;          // samples of the current fade done
+	size_t inChunk;
+
+	void boundary();
+};
+
+#endif
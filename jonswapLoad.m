@@ -0,0 +1,31 @@
+function d = jonswapLoad(file)
+% d = jonswapLoad(file) reads a binary file written by jonswapWriteFile
+% (see jonswapIO.h) into a struct with the spectrum parameters and the
+% arrays w, S, edges, wc, amps and paddleAmps as column vectors.
+ if nargin < 1
+  file = 'jonswap.bin';
+ end
+ fid = fopen(file, 'r', 'ieee-le');
+ if fid < 0
+  error('jonswapLoad: can''t open %s', file);
+ end
+ magic = fread(fid, [1 8], '*char');
+ if ~strcmp(magic(1:7), 'JONSWAP')
+  fclose(fid);
+  error('jonswapLoad: %s is not a jonswap file', file);
+ end
+ d.version = fread(fid, 1, 'uint32');
+ hsize = fread(fid, 1, 'uint32');
+ p = fread(fid, 10, 'double');
+ names = {'alpha', 'wp', 'wmax', 'gamma', 's1', 's2', 'vel10', 'F', 'g', 'depth'};
+ for k = 1:numel(names)
+  d.(names{k}) = p(k);
+ end
+ n = fread(fid, 6, 'uint64');
+ fseek(fid, hsize, 'bof');
+ arrays = {'w', 'S', 'edges', 'wc', 'amps', 'paddleAmps'};
+ for k = 1:numel(arrays)
+  d.(arrays{k}) = fread(fid, double(n(k)), 'double');
+ end
+ fclose(fid);
+end
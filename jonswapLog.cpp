@@ -0,0 +1,33 @@
+//
+//  jonswapLog.cpp
+//
+
+#include <stdio.h>
+#include <atomic>
+#include "jonswapLog.h"
+
+static void stdoutSink(int, const char *msg, void *) {
+	fputs(msg, stdout);
+	fputc('\n', stdout);
+}
+
+static jonswapLogSink sink = stdoutSink;
+static void *sinkCtx = 0;
+static std::atomic<int> logLevel(JONSWAP_LOG_TRACE);
+
+void jonswapSetLogSink(jonswapLogSink s, void *ctx) {
+	sink = s ? s : stdoutSink;
+	sinkCtx = s ? ctx : 0;
+}
+
+void jonswapSetLogLevel(int level) {
+	logLevel.store(level, std::memory_order_relaxed);
+}
+
+int jonswapGetLogLevel() {
+	return logLevel.load(std::memory_order_relaxed);
+}
+
+void jonswapLogWrite(int level, const char *msg) {
+	sink(level, msg, sinkCtx);
+}
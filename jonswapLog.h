@@ -0,0 +1,52 @@
+//
+//  jonswapLog.h
+//
+//  Diagnostics for the numerical code. Messages are compiled in only up to
+//  JONSWAP_LOG_LEVEL (default 0, nothing), so production builds pay
+//  nothing for them. Build with -DJONSWAP_LOG_LEVEL=3 (make TRACE=1) to
+//  get the per-bin bounds, areas and paddle amps the MATLAB comparison
+//  uses.
+//
+//  Messages go to a sink callback, stdout by default. A sink must be safe
+//  to call from every thread that logs, and should be installed before
+//  those threads start.
+//
+
+#ifndef JONSWAPLOG_H
+#define JONSWAPLOG_H
+
+#define JONSWAP_LOG_ERROR 1
+#define JONSWAP_LOG_INFO  2
+#define JONSWAP_LOG_TRACE 3
+
+#ifndef JONSWAP_LOG_LEVEL
+#define JONSWAP_LOG_LEVEL 0
+#endif
+
+typedef void (*jonswapLogSink)(int level, const char *msg, void *ctx);
+
+// Replace the sink (null restores stdout) and the runtime level filter
+void jonswapSetLogSink(jonswapLogSink sink, void *ctx);
+void jonswapSetLogLevel(int level);
+int jonswapGetLogLevel();
+
+void jonswapLogWrite(int level, const char *msg);
+
+// true when messages of this level are compiled in; a constant, so code
+// guarded by it disappears in quiet builds
+#define JONSWAP_LOG_ON(level) ((level) <= JONSWAP_LOG_LEVEL)
+
+#if JONSWAP_LOG_LEVEL > 0
+#include <sstream>
+#define JONSWAP_LOG(level, expr) do { \
+		if (JONSWAP_LOG_ON(level) && (level) <= jonswapGetLogLevel()) { \
+			std::ostringstream jonswapLogStream_; \
+			jonswapLogStream_ << expr; \
+			jonswapLogWrite(level, jonswapLogStream_.str().c_str()); \
+		} \
+	} while (0)
+#else
+#define JONSWAP_LOG(level, expr) do {} while (0)
+#endif
+
+#endif
@@ -0,0 +1,138 @@
+//
+//  jonswapMoments.cpp
+//
+
+#include <math.h>
+#include <algorithm>
+#include "jonswapMoments.h"
+#include "jonswapQuad.h"
+
+static const size_t LANES = 4;
+
+void jonswapAccumulateMoments(const double *f, const double *width, const double *w, size_t n,
+		double m[5]) {
+	double acc[5][LANES] = {};
+	size_t i = 0;
+	for (; i + LANES <= n; i += LANES) {
+		for (size_t l = 0; l < LANES; l++) {
+			double e = width ? f[i + l] * width[i + l] : f[i + l];
+			double x = w[i + l];
+			double ex = e * x, ex2 = ex * x;
+			acc[0][l] += e;
+			acc[1][l] += ex;
+			acc[2][l] += ex2;
+			acc[3][l] += ex2 * x;
+			acc[4][l] += ex2 * x * x;
+		}
+	}
+	for (; i < n; i++) {
+		double e = width ? f[i] * width[i] : f[i];
+		double x = w[i];
+		double ex = e * x, ex2 = ex * x;
+		acc[0][0] += e;
+		acc[1][0] += ex;
+		acc[2][0] += ex2;
+		acc[3][0] += ex2 * x;
+		acc[4][0] += ex2 * x * x;
+	}
+	for (int k = 0; k < 5; k++)
+		m[k] += (acc[k][0] + acc[k][1]) + (acc[k][2] + acc[k][3]);
+}
+
+jonswapStats jonswapStatsFromMoments(const double m[5], double wp) {
+	jonswapStats s;
+	s.m0 = m[0];
+	s.m1 = m[1];
+	s.m2 = m[2];
+	s.m3 = m[3];
+	s.m4 = m[4];
+	s.wp = wp;
+	if (!(m[0] > 0))
+		return s;
+	s.Hs = 4 * sqrt(m[0]);
+	s.Tp = wp > 0 ? 2 * M_PI / wp : 0;
+	s.Tm01 = m[1] > 0 ? 2 * M_PI * m[0] / m[1] : 0;
+	s.Tz = m[2] > 0 ? 2 * M_PI * sqrt(m[0] / m[2]) : 0;
+	double r = m[4] > 0 ? 1 - m[2] * m[2] / (m[0] * m[4]) : 0;
+	s.eps = r > 0 ? sqrt(r) : 0;
+	double q = m[1] > 0 ? m[0] * m[2] / (m[1] * m[1]) - 1 : 0;
+	s.nu = q > 0 ? sqrt(q) : 0;
+	return s;
+}
+
+jonswapStats jonswapSpectrumMoments(const jonswapEval &S, double wmax, size_t panels, int order,
+		jonswapPrecision precision) {
+	// panel edges at every peak (the peak width changes there), the panels
+	// split between the pieces by length
+	const jonswapPeakParams &m = S.peaks();
+	vector<double> at;
+	for (size_t k = 0; k < (m.n ? m.n : 1); k++) {
+		double w = m.n ? m.wp[k] : S.params().wp;
+		if (w > 0 && w < wmax)
+			at.push_back(w);
+	}
+	std::sort(at.begin(), at.end());
+	at.erase(std::unique(at.begin(), at.end()), at.end());
+	if (panels < at.size() + 1)
+		panels = at.size() + 1;
+
+	vector<double> edges(panels + 1);
+	edges[0] = 0;
+	size_t i0 = 0;
+	double a = 0;
+	for (size_t j = 0; j <= at.size(); j++) {
+		double b = j < at.size() ? at[j] : wmax;
+		size_t i1 = panels;
+		if (j < at.size()) {
+			i1 = (size_t) floor(panels * b / wmax + 0.5);
+			i1 = i1 < i0 + 1 ? i0 + 1 : i1 > panels - (at.size() - j) ? panels - (at.size() - j) : i1;
+		}
+		for (size_t i = i0 + 1; i <= i1; i++)
+			edges[i] = a + (i - i0) * (b - a) / (i1 - i0);
+		i0 = i1;
+		a = b;
+	}
+
+	// the highest of the peaks
+	double wp = S.params().wp;
+	for (size_t k = 0, best = 0; k < m.n; k++) {
+		if (!k || S(m.wp[k]) > S(m.wp[best])) {
+			best = k;
+			wp = m.wp[k];
+		}
+	}
+
+	jonswapQuad quad(order);
+	quad.setPrecision(precision);
+	double mm[5];
+	quad.moments(S, &edges[0], panels, mm);
+	return jonswapStatsFromMoments(mm, wp);
+}
+
+jonswapStats jonswapBinMoments(const double *energy, const double *wc, size_t n) {
+	double m[5] = { 0, 0, 0, 0, 0 };
+	jonswapAccumulateMoments(energy, NULL, wc, n, m);
+	double peak = -1, wp = 0;
+	for (size_t i = 0; i < n; i++) {
+		if (energy[i] > peak) {
+			peak = energy[i];
+			wp = wc[i];
+		}
+	}
+	return jonswapStatsFromMoments(m, wp);
+}
+
+jonswapStats jonswapBinMoments(const jonswapBins &bins) {
+	size_t n = bins.size();
+	double m[5] = { 0, 0, 0, 0, 0 };
+	if (n)
+		jonswapAccumulateMoments(&bins.amps[0], &bins.width[0], &bins.wc[0], n, m);
+	double peak = -1, wp = 0;
+	for (size_t i = 0; i < n; i++) {
+		if (bins.amps[i] > peak) {
+			peak = bins.amps[i];
+			wp = bins.wc[i];
+		}
+	}
+	return jonswapStatsFromMoments(m, wp);
+}
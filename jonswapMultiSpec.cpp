@@ -0,0 +1,46 @@
+//
+//  jonswapMultiSpec.cpp
+//
+
+#include "jonswapMultiSpec.h"
+
+jonswapMultiSpec::jonswapMultiSpec(const jonswapSpec &spec) : jonswapSpec(spec) {
+}
+
+// peak 0 is (re)filled by setPeaks
+bool jonswapMultiSpec::addPeak(double alpha, double wp, double gamma, double s1, double s2) {
+	jonswapPeakParams m = getPeakParams();
+	if (!m.n)
+		m.n = 1;
+	if (m.n >= JONSWAP_MAX_PEAKS || !(wp > 0))
+		return false;
+	jonswapSetPeak(m, m.n, jonswapMakeKernelParams(alpha, wp, gamma, s1, s2, getG()));
+	setPeaks(m);
+	return true;
+}
+
+bool jonswapMultiSpec::addPeak(const jonswapSpecParams &p) {
+	return addPeak(p.alpha, p.wp, p.gamma, p.s1, p.s2);
+}
+
+void jonswapMultiSpec::clearPeaks() {
+	if (!getPeakParams().n)
+		return;
+	jonswapPeakParams m = getPeakParams();
+	m.n = 0;
+	setPeaks(m);
+}
+
+jonswapSpecParams jonswapMultiSpec::getPeak(size_t k) const {
+	const jonswapPeakParams &m = getPeakParams();
+	jonswapSpecParams p = { getAlpha(), getWp(), getWmax(), getGamma(), getS1(), getS2() };
+	if (k == 0 || k >= m.n)
+		return p;
+	double g = getG();
+	p.alpha = m.c[k] / (g * g);
+	p.wp = m.wp[k];
+	p.gamma = exp(m.lng[k]);
+	p.s1 = sqrt(0.5 / m.ks0[k]) / p.wp;
+	p.s2 = sqrt(0.5 / m.ks1[k]) / p.wp;
+	return p;
+}
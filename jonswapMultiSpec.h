@@ -0,0 +1,48 @@
+//
+//  jonswapMultiSpec.h
+//
+//  Composite spectrum: the sum of up to JONSWAP_MAX_PEAKS JONSWAP peaks,
+//  e.g. a wind sea and one or more swells
+//
+//      S(w) = w^-5 sum_k alpha_k g^2 exp[-1.2 (wp_k/w)^4] gamma_k^r_k(w)
+//
+//  The peaks are kept as one array per invariant (jonswapPeakParams), and
+//  every evaluation computes 1/w, w^-4 and w^-5 once for all of them. The
+//  base jonswapSpec is peak 0 and its setters keep working on it, while
+//  binning, integration, CDF tables, moments, the pipeline and the paddle
+//  stage see the sum through jonswapEval without knowing about the peaks.
+//
+//  The band is the base spectrum's [0, wmax]; give the base the widest
+//  wmax of the peaks.
+//
+
+#ifndef JONSWAPMULTISPEC_H
+#define JONSWAPMULTISPEC_H
+
+#include "jonswapSpec.h"
+#include "jonswapSolve.h"
+
+class jonswapMultiSpec : public jonswapSpec
+{
+public:
+	// spec is peak 0, or all peaks if it is a composite itself
+	explicit jonswapMultiSpec(const jonswapSpec &spec);
+
+	// Add a peak; false once there are JONSWAP_MAX_PEAKS or if wp <= 0.
+	// Invalidates amps and paddle amps like a change of wp.
+	bool addPeak(double alpha, double wp, double gamma = 3.3, double s1 = 0.07, double s2 = 0.09);
+	// from jonswapParamSolver::solve() of the peak's (Hs, Tp, gamma); its
+	// wmax is not used
+	bool addPeak(const jonswapSpecParams &p);
+
+	// drop all peaks but peak 0
+	void clearPeaks();
+
+	size_t peakCount() const { return getPeakParams().n ? getPeakParams().n : 1; }
+
+	// parameters of peak k < peakCount(), with the composite's wmax. Peaks
+	// k > 0 are recovered from their invariants, so they follow setHs()
+	jonswapSpecParams getPeak(size_t k) const;
+};
+
+#endif
@@ -0,0 +1,159 @@
+//
+//  jonswapPaddle.cpp
+//
+
+#include <math.h>
+#include "jonswapPaddle.h"
+#include "jonswapProfile.h"
+
+void jonswapDispersion(const double *w, size_t n, double h, double *kh, int newton, double g) {
+	for (size_t i = 0; i < n; i++) {
+		double k0h = w[i] * w[i] / g * h;
+		double x = k0h * sqrt(sqrt(k0h)); // (k0h)^1.25
+		double k = k0h * pow(-expm1(-x), -0.4);
+
+		// f(k) = k tanh(k) - k0h, with tanh and sech^2 from one exp
+		for (int it = 0; it < newton; it++) {
+			double e = exp(-2 * k);
+			double t = (1 - e) / (1 + e);
+			double f = k * t - k0h;
+			double df = t + k * (1 - t * t);
+			k -= f / df;
+		}
+		kh[i] = k0h > 0 ? k : 0;
+	}
+}
+
+// Everything below is in q = exp(-kh), a1 = 1-q, a2 = 1-q^2, a4 = 1-q^4,
+// with den = 2 q^2 (sinh 2kh + 2kh) = a4 + 4 kh q^2. For a paddle moving as
+// S f(z), H/S = 4 sinh kh/(sinh 2kh + 2kh) * k int_{-h}^0 f cosh k(h+z) dz:
+//   piston  f = 1                H/S = 2 a2^2 / den
+//   flap    f = (z+h)/h          H/S = 2 a2 (kh a2 - a1^2) / (kh den)
+//   hinged  f = (z+d)/d, z > -d  H/S = 2 a2 (a2 - (1 + q^2 - c)/kd) / den
+// where c = 2 q cosh k(h-d) = exp(-kd) + exp(-k(2h-d)), or 2q if d >= h.
+namespace {
+
+struct qterms {
+	double q, a1, a2, den;
+
+	explicit qterms(double k) {
+		a1 = -expm1(-k);
+		q = 1 - a1;
+		a2 = a1 * (1 + q);
+		den = a2 * (1 + q * q) + 4 * k * q * q;
+	}
+};
+
+struct pistonTF {
+	explicit pistonTF(const jonswapPaddleModel &, double) {}
+	double operator()(double k) const {
+		qterms t(k);
+		return 2 * t.a2 * t.a2 / t.den;
+	}
+};
+
+struct flapTF {
+	explicit flapTF(const jonswapPaddleModel &, double) {}
+	double operator()(double k) const {
+		if (k == 0)
+			return 0;
+		qterms t(k);
+		return 2 * t.a2 * (k * t.a2 - t.a1 * t.a1) / (k * t.den);
+	}
+};
+
+struct hingedTF {
+	double r, below;  // hinge depth over water depth, and 1 - r
+
+	hingedTF(const jonswapPaddleModel &m, double h)
+		: r(m.hinge / h), below(m.hinge < h ? 1 - m.hinge / h : 0) {}
+
+	double operator()(double k) const {
+		if (k == 0 || r <= 0)
+			return 0;
+		qterms t(k);
+		double kd = k * r;
+		double c = below > 0 ? exp(-kd) + exp(-k * (1 + below)) : 2 * t.q;
+		return 2 * t.a2 * (t.a2 - (1 + t.q * t.q - c) / kd) / t.den;
+	}
+};
+
+template<class TF>
+void transferLoop(const jonswapPaddleModel &model, const double *kh, size_t n, double h, double *HoS) {
+	TF tf(model, h);
+	for (size_t i = 0; i < n; i++)
+		HoS[i] = tf(kh[i]);
+}
+
+typedef void (*transferFn)(const jonswapPaddleModel &, const double *, size_t, double, double *);
+
+// indexed by jonswapPaddleType
+const transferFn TRANSFER[JONSWAP_PADDLE_TYPES] = {
+	transferLoop<flapTF>,
+	transferLoop<pistonTF>,
+	transferLoop<hingedTF>
+};
+
+const char *const NAMES[JONSWAP_PADDLE_TYPES] = { "flap", "piston", "hinged" };
+
+}
+
+void jonswapTransfer(const jonswapPaddleModel &model, const double *kh, size_t n, double h, double *HoS) {
+	int type = model.type < JONSWAP_PADDLE_TYPES ? model.type : JONSWAP_PADDLE_FLAP;
+	TRANSFER[type](model, kh, n, h, HoS);
+}
+
+const char *jonswapPaddleName(jonswapPaddleType type) {
+	return type < JONSWAP_PADDLE_TYPES ? NAMES[type] : "unknown";
+}
+
+jonswapTransferCache::jonswapTransferCache(const jonswapPaddleModel &model, int newton,
+		size_t maxTables)
+	: model(model), newton(newton), cap(maxTables ? maxTables : 1), uses(0), nsolves(0) {
+}
+
+void jonswapTransferCache::setFrequencies(const vector<double> &w) {
+	if (w == wc)
+		return;
+	wc = w;
+	kh.resize(wc.size());
+	cache.clear();
+}
+
+void jonswapTransferCache::setModel(const jonswapPaddleModel &m) {
+	if (m == model)
+		return;
+	model = m;
+	cache.clear();
+}
+
+const vector<double> &jonswapTransferCache::HoS(double h) {
+	std::map<double, table>::iterator it = cache.find(h);
+	if (it != cache.end()) {
+		JONSWAP_PROFILE_COUNT(JONSWAP_COUNT_HOS_HITS, 1);
+		it->second.used = ++uses;
+		return it->second.HoS;
+	}
+	JONSWAP_PROFILE_COUNT(JONSWAP_COUNT_HOS_SOLVES, 1);
+	nsolves++;
+
+	// full: the least recently used table makes room, and lends its storage
+	vector<double> spare;
+	if (cache.size() >= cap) {
+		std::map<double, table>::iterator lru = cache.begin();
+		for (it = cache.begin(); it != cache.end(); ++it)
+			if (it->second.used < lru->second.used)
+				lru = it;
+		spare.swap(lru->second.HoS);
+		cache.erase(lru);
+	}
+	table &t = cache[h];
+	t.HoS.swap(spare);
+	t.used = ++uses;
+	t.HoS.resize(wc.size());
+	if (wc.size()) {
+		jonswapDispersion(&wc[0], wc.size(), h, &kh[0], newton);
+		jonswapTransfer(model, &kh[0], kh.size(), h, &t.HoS[0]);
+	}
+	return t.HoS;
+}
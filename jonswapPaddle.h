@@ -0,0 +1,105 @@
+//
+//  jonswapPaddle.h
+//
+//  Wavemaker transfer functions from linear wave theory.
+//
+//  kh comes from the explicit dispersion approximation
+//      kh = k0h (1 - exp(-(k0h)^1.25))^-0.4,  k0 = w^2/g
+//  optionally refined by Newton steps on w^2 = g k tanh(kh). The
+//  height-to-stroke ratios H/S are written with q = exp(-kh) only, so a
+//  single expm1 per bin replaces the separate sinh/cosh of kh and 2kh and
+//  nothing overflows in deep water.
+//
+//  A jonswapPaddleModel names the paddle geometry. The model is looked up
+//  once per call and each geometry has its own loop, so there is no branch
+//  per bin. jonswapTransferCache keeps H/S per water depth for one set of
+//  bin frequencies and one model, so switching between a few depths costs
+//  no recomputation. It holds at most maxTables depths and drops the least
+//  recently used one for a new depth, so a tide ramped through many depths
+//  keeps a bounded amount of memory.
+//
+
+#ifndef JONSWAPPADDLE_H
+#define JONSWAPPADDLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <map>
+#include <vector>
+
+using std::vector;
+
+enum jonswapPaddleType {
+	JONSWAP_PADDLE_FLAP = 0,  // hinged at the bed
+	JONSWAP_PADDLE_PISTON,    // uniform stroke over the depth
+	JONSWAP_PADDLE_HINGED,    // hinged at a given depth below still water
+	JONSWAP_PADDLE_TYPES
+};
+
+// Stroke S is measured at the still water level. For a hinged flap the
+// paddle moves as (z + hinge)/hinge above the hinge and not at all below
+// it; a hinge deeper than the water acts as a flap on a virtual hinge
+// under the bed, and hinge = h is the same as JONSWAP_PADDLE_FLAP.
+struct jonswapPaddleModel {
+	jonswapPaddleType type;
+	double hinge;  // m below still water, JONSWAP_PADDLE_HINGED only
+
+	jonswapPaddleModel(jonswapPaddleType type = JONSWAP_PADDLE_FLAP, double hinge = 0)
+		: type(type), hinge(hinge) {}
+
+	bool operator==(const jonswapPaddleModel &o) const {
+		return type == o.type && (type != JONSWAP_PADDLE_HINGED || hinge == o.hinge);
+	}
+	bool operator!=(const jonswapPaddleModel &o) const { return !(*this == o); }
+};
+
+// kh for n angular frequencies at depth h; newton = 0 keeps the explicit
+// approximation (about 0.1% error), 2-3 steps reach full precision
+void jonswapDispersion(const double *w, size_t n, double h, double *kh,
+		int newton = 0, double g = 9.81);
+
+// H/S of the model for n values of kh at depth h; HoS may alias kh
+void jonswapTransfer(const jonswapPaddleModel &model, const double *kh, size_t n,
+		double h, double *HoS);
+
+const char *jonswapPaddleName(jonswapPaddleType type);
+
+class jonswapTransferCache
+{
+public:
+	explicit jonswapTransferCache(const jonswapPaddleModel &model = jonswapPaddleModel(),
+			int newton = 0, size_t maxTables = 8);
+
+	// Bin frequencies the tables are for; drops every table if they change
+	void setFrequencies(const vector<double> &wc);
+
+	// Paddle geometry; drops every table if it changes
+	void setModel(const jonswapPaddleModel &model);
+	const jonswapPaddleModel &getModel() const { return model; }
+
+	// H/S of every bin at depth h, computed on first use. The reference
+	// holds until the next call for a depth not in the cache, which may
+	// evict it.
+	const vector<double> &HoS(double h);
+
+	size_t tables() const { return cache.size(); }
+	size_t maxTables() const { return cap; }
+	// tables computed so far, hits excluded
+	uint64_t solves() const { return nsolves; }
+	void clear() { cache.clear(); }
+
+private:
+	struct table {
+		vector<double> HoS;
+		uint64_t used;     // value of uses at the last lookup
+	};
+
+	jonswapPaddleModel model;
+	int newton;
+	size_t cap;
+	uint64_t uses, nsolves;
+	vector<double> wc, kh;
+	std::map<double, table> cache;
+};
+
+#endif
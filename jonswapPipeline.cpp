@@ -0,0 +1,101 @@
+//
+//  jonswapPipeline.cpp
+//
+
+#include <math.h>
+#include "jonswapPipeline.h"
+#include "jonswapPaddle.h"
+#include "jonswapProfile.h"
+
+void jonswapAreasToAmps(jonswapBins &bins) {
+	for (size_t i = 0; i < bins.size(); i++)
+		bins.amps[i] /= bins.width[i];
+}
+
+void jonswapBinAmps(const jonswapEval &S, jonswapQuad &quad, jonswapBins &bins) {
+	bins.amps.resize(bins.size());
+	if (!bins.size())
+		return;
+
+	quad.integrate(S, &bins.edges[0], bins.size(), &bins.amps[0]);
+	jonswapAreasToAmps(bins);
+}
+
+void jonswapPaddleAmps(jonswapBins &bins, double h, const jonswapPaddleModel &model) {
+	size_t n = bins.amps.size();
+
+	// paddleAmps holds kh, then H/S, then the stroke
+	bins.paddleAmps.resize(n);
+	if (n == 0)
+		return;
+	double *out = &bins.paddleAmps[0];
+	jonswapDispersion(&bins.wc[0], n, h, out);
+	jonswapTransfer(model, out, n, h, out);
+	for (size_t i = 0; i < n; i++)
+		out[i] = sqrt(bins.amps[i]*bins.width[i]*2)/out[i];
+}
+
+void jonswapPaddleAmps(jonswapBins &bins, const double *HoS) {
+	bins.paddleAmps.resize(bins.amps.size());
+	for (size_t i = 0; i < bins.amps.size(); i++)
+		bins.paddleAmps[i] = sqrt(bins.amps[i]*bins.width[i]*2)/HoS[i];
+}
+
+jonswapPipeline::jonswapPipeline(const jonswapSpec &spec, uint64_t seed)
+	: eval(spec), wmax(spec.getWmax()), rng(seed), mode(JONSWAP_BINS_JITTER), paddle() {
+}
+
+void jonswapPipeline::reserve(int nbins, int nmems, jonswapBins &out) {
+	out.reserve(nbins);
+	quad.setOrder(nmems);
+	vector<double> edges(nbins + 1), area(nbins);
+	for (int i = 0; i <= nbins; i++)
+		edges[i] = i * wmax / nbins;
+	quad.integrate(eval, &edges[0], nbins, &area[0]);
+}
+
+void jonswapPipeline::setEdgeOptions(const jonswapEdgeOptions &o) {
+	mode = JONSWAP_BINS_EDGES;
+	edgeOpts = o;
+	if (o.spacing == JONSWAP_SPACING_ENERGY && !o.cdf) {
+		if (!cdf)
+			cdf = std::make_shared<const jonswapCDF>(eval, wmax);
+		edgeOpts.cdf = cdf.get();
+	}
+}
+
+void jonswapPipeline::bin(int nbins, jonswapBins &out) {
+	JONSWAP_PROFILE_SCOPE(JONSWAP_STAGE_BIN);
+	if (mode == JONSWAP_BINS_EDGES) {
+		jonswapEdges(edgeOpts, wmax, nbins, rng, out.edges);
+	} else if (mode == JONSWAP_BINS_NORMAL) {
+		double wp = eval.params().wp;
+		struct {
+			jonswapRng *rng;
+			double wp;
+			double operator()() { return wp + wp/2 * rng->normal(); }
+		} draw = { &rng, wp };
+		jonswapNormalEdges(wmax, nbins, draw, out.edges);
+	} else {
+		jonswapJitterEdges(wmax, nbins, rng, out.edges);
+	}
+	out.setCenters();
+	JONSWAP_PROFILE_COUNT(JONSWAP_COUNT_BINS, out.size());
+}
+
+void jonswapPipeline::calcBinAmps(int nmems, jonswapBins &out) {
+	JONSWAP_PROFILE_SCOPE(JONSWAP_STAGE_AMPS);
+	quad.setOrder(nmems);
+	jonswapBinAmps(eval, quad, out);
+}
+
+void jonswapPipeline::calcPaddleAmps(double h, jonswapBins &out) {
+	JONSWAP_PROFILE_SCOPE(JONSWAP_STAGE_PADDLE);
+	jonswapPaddleAmps(out, h, paddle);
+}
+
+void jonswapPipeline::run(int nbins, int nmems, double h, jonswapBins &out) {
+	bin(nbins, out);
+	calcBinAmps(nmems, out);
+	calcPaddleAmps(h, out);
+}
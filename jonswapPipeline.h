@@ -0,0 +1,118 @@
+//
+//  jonswapPipeline.h
+//
+//  Re-entrant bin -> amps -> paddle amps pipeline. The pipeline owns only
+//  a workspace (quadrature scratch and a random stream); results go into
+//  a jonswapBins the caller owns. Every stage resizes its arrays to the
+//  bin count, so once a jonswapBins and the pipeline have seen their
+//  largest run, repeating it does not touch the heap.
+//
+//  The stage functions below are shared with jonswapSpec.
+//
+
+#ifndef JONSWAPPIPELINE_H
+#define JONSWAPPIPELINE_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <memory>
+#include "jonswapSpec.h"
+#include "jonswapEval.h"
+#include "jonswapQuad.h"
+#include "jonswapRng.h"
+#include "jonswapBins.h"
+#include "jonswapPaddle.h"
+#include "jonswapEdges.h"
+#include "jonswapCDF.h"
+
+// n bins over [0, wmax]: each interior bound is i*wmax/n jittered by
+// [-0.5, -0.1] of a bin width, so edges come out sorted. uniform() must
+// return values in [0, 1].
+template<class Uniform>
+void jonswapJitterEdges(double wmax, int n, Uniform &uniform, vector<double> &edges) {
+	double range = 0.4 * (wmax / n); // range is +- 2.5% of bin width
+	double offset = -wmax / (2*n); // center range around 0
+
+	edges.resize(n + 1);
+	edges[0] = 0.0;
+	for (int i = 1; i < n; i++)
+		edges[i] = i * wmax/n + uniform() * range + offset;
+	edges[n] = wmax;
+}
+
+// n bins over [0, wmax] with n-1 interior bounds drawn from draw() (normally
+// N(wp, wp/2)), rejected outside (0, wmax), sorted, duplicates drawn again
+template<class Draw>
+void jonswapNormalEdges(double wmax, int n, Draw &draw, vector<double> &edges) {
+	edges.clear();
+	edges.push_back(0.0);
+	while (edges.size() < (size_t) n) {
+		double bound = draw();
+		if (bound > 0 && bound < wmax) {
+			edges.push_back(bound);
+		}
+		if (edges.size() == (size_t) n) {
+			std::sort(edges.begin(), edges.end());
+			edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+		}
+	}
+	edges.push_back(wmax);
+}
+
+// How the pipeline places bin edges
+enum jonswapBinMode {
+	JONSWAP_BINS_JITTER = 0, // jittered uniform grid, as bin()
+	JONSWAP_BINS_NORMAL,     // normal around wp, as bin() with USE_CPP11
+	JONSWAP_BINS_EDGES       // jonswapEdges with the options of setEdgeOptions
+};
+
+// Turn bin areas in bins.amps into amps (mean spectral density) by
+// dividing every bin by its width
+void jonswapAreasToAmps(jonswapBins &bins);
+
+// Integrate S over every bin into bins.amps, then jonswapAreasToAmps
+void jonswapBinAmps(const jonswapEval &S, jonswapQuad &quad, jonswapBins &bins);
+
+// Paddle stroke of every bin for water depth h with linear wave theory
+void jonswapPaddleAmps(jonswapBins &bins, double h,
+		const jonswapPaddleModel &model = jonswapPaddleModel());
+
+// Same with H/S per bin given, e.g. from a jonswapTransferCache
+void jonswapPaddleAmps(jonswapBins &bins, const double *HoS);
+
+class jonswapPipeline
+{
+public:
+	explicit jonswapPipeline(const jonswapSpec &spec, uint64_t seed = 0);
+
+	void seed(uint64_t s) { rng.seed(s); }
+
+	void setBinMode(jonswapBinMode m) { mode = m; }
+	void setPaddleModel(const jonswapPaddleModel &m) { paddle = m; }
+	// Also selects JONSWAP_BINS_EDGES. Energy spacing without o.cdf uses a
+	// CDF table of the pipeline's spectrum, built here once.
+	void setEdgeOptions(const jonswapEdgeOptions &o);
+	const jonswapEdgeOptions &getEdgeOptions() const { return edgeOpts; }
+
+	// Size out and the workspace for nbins bins up front
+	void reserve(int nbins, int nmems, jonswapBins &out);
+
+	void bin(int nbins, jonswapBins &out);
+	void calcBinAmps(int nmems, jonswapBins &out);
+	void calcPaddleAmps(double h, jonswapBins &out);
+
+	// All three stages
+	void run(int nbins, int nmems, double h, jonswapBins &out);
+
+private:
+	jonswapEval eval;
+	double wmax;
+	jonswapQuad quad;
+	jonswapRng rng;
+	jonswapBinMode mode;
+	jonswapPaddleModel paddle;
+	jonswapEdgeOptions edgeOpts;
+	std::shared_ptr<const jonswapCDF> cdf;  // shared by copies of the pipeline
+};
+
+#endif
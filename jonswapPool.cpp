@@ -0,0 +1,79 @@
+//
+//  jonswapPool.cpp
+//
+
+#include "jonswapPool.h"
+
+jonswapPool::jonswapPool(unsigned nthreads)
+	: job(0), jobN(0), jobGrain(1), nextIndex(0), busy(0), generation(0), stop(false) {
+	if (nthreads == 0)
+		nthreads = std::thread::hardware_concurrency();
+	if (nthreads == 0)
+		nthreads = 1;
+	for (unsigned i = 1; i < nthreads; i++)
+		threads.push_back(std::thread(&jonswapPool::workerLoop, this, i));
+}
+
+jonswapPool::~jonswapPool() {
+	{
+		std::lock_guard<std::mutex> lk(m);
+		stop = true;
+	}
+	wake.notify_all();
+	for (size_t i = 0; i < threads.size(); i++)
+		threads[i].join();
+}
+
+void jonswapPool::work(unsigned id) {
+	for (;;) {
+		size_t begin = nextIndex.fetch_add(jobGrain);
+		if (begin >= jobN)
+			break;
+		size_t end = begin + jobGrain < jobN ? begin + jobGrain : jobN;
+		(*job)(begin, end, id);
+	}
+}
+
+void jonswapPool::workerLoop(unsigned id) {
+	uint64_t seen = 0;
+	for (;;) {
+		std::unique_lock<std::mutex> lk(m);
+		wake.wait(lk, [&]() { return stop || generation != seen; });
+		if (stop)
+			return;
+		seen = generation;
+		lk.unlock();
+
+		work(id);
+
+		lk.lock();
+		if (--busy == 0)
+			done.notify_all();
+	}
+}
+
+void jonswapPool::parallelFor(size_t n, size_t grain,
+		const std::function<void(size_t, size_t, unsigned)> &f) {
+	if (n == 0)
+		return;
+	if (grain == 0)
+		grain = 1;
+
+	std::lock_guard<std::mutex> run(runLock);
+	{
+		std::lock_guard<std::mutex> lk(m);
+		job = &f;
+		jobN = n;
+		jobGrain = grain;
+		nextIndex.store(0);
+		busy = (unsigned) threads.size();
+		generation++;
+	}
+	wake.notify_all();
+
+	work(0);
+
+	std::unique_lock<std::mutex> lk(m);
+	done.wait(lk, [&]() { return busy == 0; });
+	job = 0;
+}
@@ -0,0 +1,56 @@
+//
+//  jonswapPool.h
+//
+//  Fixed pool of worker threads for data-parallel loops. parallelFor hands
+//  out chunks of the index range from a shared atomic counter, so fast
+//  workers keep taking chunks until the range is used up. The calling
+//  thread works too, as worker 0.
+//
+
+#ifndef JONSWAPPOOL_H
+#define JONSWAPPOOL_H
+
+#include <stdint.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+class jonswapPool
+{
+public:
+	// nthreads = 0 uses every hardware thread
+	explicit jonswapPool(unsigned nthreads = 0);
+	~jonswapPool();
+
+	// number of workers, the calling thread included
+	unsigned size() const { return (unsigned) threads.size() + 1; }
+
+	// Call f(begin, end, worker) on chunks of [0, n) of at most grain
+	// indices; returns when all are done. worker < size() identifies the
+	// thread, e.g. to pick a per-worker workspace. One loop runs at a time.
+	void parallelFor(size_t n, size_t grain,
+			const std::function<void(size_t, size_t, unsigned)> &f);
+
+private:
+	std::vector<std::thread> threads;
+	std::mutex m, runLock;
+	std::condition_variable wake, done;
+
+	const std::function<void(size_t, size_t, unsigned)> *job;
+	size_t jobN, jobGrain;
+	std::atomic<size_t> nextIndex;
+	unsigned busy;
+	uint64_t generation;
+	bool stop;
+
+	void workerLoop(unsigned id);
+	void work(unsigned id);
+
+	jonswapPool(const jonswapPool &);
+	jonswapPool &operator=(const jonswapPool &);
+};
+
+#endif
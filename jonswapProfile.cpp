@@ -0,0 +1,206 @@
+//
+//  jonswapProfile.cpp
+//
+
+#include <stdio.h>
+#include <ostream>
+#include "jonswapProfile.h"
+
+static const char *STAGE_NAMES[JONSWAP_STAGES] = { "bin", "amps", "paddle", "cdf", "synth" };
+static const char *COUNTER_NAMES[JONSWAP_COUNTERS] = {
+	"evals", "bins", "hos_solves", "hos_hits", "samples"
+};
+
+const char *jonswapStageName(jonswapStage s) {
+	return s >= 0 && s < JONSWAP_STAGES ? STAGE_NAMES[s] : "?";
+}
+
+const char *jonswapCounterName(jonswapCounter c) {
+	return c >= 0 && c < JONSWAP_COUNTERS ? COUNTER_NAMES[c] : "?";
+}
+
+jonswapProfileSnapshot::jonswapProfileSnapshot() {
+	for (int s = 0; s < JONSWAP_STAGES; s++) {
+		calls[s] = 0;
+		seconds[s] = 0;
+	}
+	for (int c = 0; c < JONSWAP_COUNTERS; c++)
+		counts[c] = 0;
+}
+
+std::string jonswapProfileSnapshot::json() const {
+	std::string out = "{\"enabled\": ";
+	out += jonswapProfileEnabled() ? "true" : "false";
+	out += ", \"stages\": {";
+	char buf[128];
+	for (int s = 0; s < JONSWAP_STAGES; s++) {
+		snprintf(buf, sizeof(buf), "%s\"%s\": {\"calls\": %llu, \"seconds\": %.9g}", s ? ", " : "",
+			STAGE_NAMES[s], (unsigned long long) calls[s], seconds[s]);
+		out += buf;
+	}
+	out += "}, \"counters\": {";
+	for (int c = 0; c < JONSWAP_COUNTERS; c++) {
+		snprintf(buf, sizeof(buf), "%s\"%s\": %llu", c ? ", " : "", COUNTER_NAMES[c],
+			(unsigned long long) counts[c]);
+		out += buf;
+	}
+	out += "}}";
+	return out;
+}
+
+void jonswapProfileSnapshot::print(std::ostream &out) const {
+	char buf[128];
+	out << "stage        calls      seconds\n";
+	for (int s = 0; s < JONSWAP_STAGES; s++) {
+		snprintf(buf, sizeof(buf), "%-8s %9llu %12.6f\n", STAGE_NAMES[s],
+			(unsigned long long) calls[s], seconds[s]);
+		out << buf;
+	}
+	for (int c = 0; c < JONSWAP_COUNTERS; c++) {
+		snprintf(buf, sizeof(buf), "%-12s %12llu\n", COUNTER_NAMES[c], (unsigned long long) counts[c]);
+		out << buf;
+	}
+}
+
+#if JONSWAP_PROFILE
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// Written only by its thread, with relaxed stores, so readers need no lock
+// on the hot path and see a value at most one update old.
+struct threadRecord {
+	std::atomic<uint64_t> calls[JONSWAP_STAGES];
+	std::atomic<uint64_t> nanos[JONSWAP_STAGES];
+	std::atomic<uint64_t> counts[JONSWAP_COUNTERS];
+
+	threadRecord();
+	~threadRecord();
+
+	static void bump(std::atomic<uint64_t> &a, uint64_t n) {
+		a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+	}
+};
+
+struct registry {
+	std::mutex lock;
+	std::vector<threadRecord *> live;
+	uint64_t calls[JONSWAP_STAGES], nanos[JONSWAP_STAGES], counts[JONSWAP_COUNTERS];  // exited threads
+
+	registry() { clearRetired(); }
+
+	void clearRetired() {
+		for (int s = 0; s < JONSWAP_STAGES; s++)
+			calls[s] = nanos[s] = 0;
+		for (int c = 0; c < JONSWAP_COUNTERS; c++)
+			counts[c] = 0;
+	}
+};
+
+// never destroyed, so records of threads exiting after main can still retire
+registry &reg() {
+	static registry *r = new registry;
+	return *r;
+}
+
+threadRecord::threadRecord() {
+	for (int s = 0; s < JONSWAP_STAGES; s++) {
+		calls[s].store(0, std::memory_order_relaxed);
+		nanos[s].store(0, std::memory_order_relaxed);
+	}
+	for (int c = 0; c < JONSWAP_COUNTERS; c++)
+		counts[c].store(0, std::memory_order_relaxed);
+	std::lock_guard<std::mutex> g(reg().lock);
+	reg().live.push_back(this);
+}
+
+threadRecord::~threadRecord() {
+	registry &r = reg();
+	std::lock_guard<std::mutex> g(r.lock);
+	for (int s = 0; s < JONSWAP_STAGES; s++) {
+		r.calls[s] += calls[s].load(std::memory_order_relaxed);
+		r.nanos[s] += nanos[s].load(std::memory_order_relaxed);
+	}
+	for (int c = 0; c < JONSWAP_COUNTERS; c++)
+		r.counts[c] += counts[c].load(std::memory_order_relaxed);
+	for (size_t i = 0; i < r.live.size(); i++) {
+		if (r.live[i] == this) {
+			r.live.erase(r.live.begin() + i);
+			break;
+		}
+	}
+}
+
+thread_local threadRecord local;
+
+}
+
+void jonswapProfileAdd(jonswapCounter c, uint64_t n) {
+	threadRecord::bump(local.counts[c], n);
+}
+
+void jonswapProfileStage(jonswapStage s, uint64_t nanos) {
+	threadRecord::bump(local.calls[s], 1);
+	threadRecord::bump(local.nanos[s], nanos);
+}
+
+bool jonswapProfileEnabled() {
+	return true;
+}
+
+jonswapProfileSnapshot jonswapProfileGet() {
+	registry &r = reg();
+	std::lock_guard<std::mutex> g(r.lock);
+	uint64_t nanos[JONSWAP_STAGES];
+	jonswapProfileSnapshot snap;
+	for (int s = 0; s < JONSWAP_STAGES; s++) {
+		snap.calls[s] = r.calls[s];
+		nanos[s] = r.nanos[s];
+	}
+	for (int c = 0; c < JONSWAP_COUNTERS; c++)
+		snap.counts[c] = r.counts[c];
+	for (size_t i = 0; i < r.live.size(); i++) {
+		const threadRecord &t = *r.live[i];
+		for (int s = 0; s < JONSWAP_STAGES; s++) {
+			snap.calls[s] += t.calls[s].load(std::memory_order_relaxed);
+			nanos[s] += t.nanos[s].load(std::memory_order_relaxed);
+		}
+		for (int c = 0; c < JONSWAP_COUNTERS; c++)
+			snap.counts[c] += t.counts[c].load(std::memory_order_relaxed);
+	}
+	for (int s = 0; s < JONSWAP_STAGES; s++)
+		snap.seconds[s] = nanos[s] * 1e-9;
+	return snap;
+}
+
+void jonswapProfileReset() {
+	registry &r = reg();
+	std::lock_guard<std::mutex> g(r.lock);
+	r.clearRetired();
+	for (size_t i = 0; i < r.live.size(); i++) {
+		threadRecord &t = *r.live[i];
+		for (int s = 0; s < JONSWAP_STAGES; s++) {
+			t.calls[s].store(0, std::memory_order_relaxed);
+			t.nanos[s].store(0, std::memory_order_relaxed);
+		}
+		for (int c = 0; c < JONSWAP_COUNTERS; c++)
+			t.counts[c].store(0, std::memory_order_relaxed);
+	}
+}
+
+#else
+
+bool jonswapProfileEnabled() {
+	return false;
+}
+
+jonswapProfileSnapshot jonswapProfileGet() {
+	return jonswapProfileSnapshot();
+}
+
+void jonswapProfileReset() {
+}
+
+#endif
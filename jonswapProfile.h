@@ -0,0 +1,97 @@
+//
+//  jonswapProfile.h
+//
+//  Opt-in instrumentation of the hot paths: call counts and inclusive wall
+//  time per stage, and event counters (spectrum evaluations, bins, H/S
+//  solves, ...). Like the log, it is compiled in only with
+//  -DJONSWAP_PROFILE=1 (make PROFILE=1); otherwise the macros expand to
+//  nothing and the snapshot stays zero, so builds without it pay nothing.
+//
+//  Every thread accumulates into its own thread_local record, which only
+//  that thread writes. jonswapProfileGet() sums the records of running
+//  threads and the totals left by threads that have exited.
+//
+
+#ifndef JONSWAPPROFILE_H
+#define JONSWAPPROFILE_H
+
+#include <stdint.h>
+#include <string>
+#include <iosfwd>
+
+#ifndef JONSWAP_PROFILE
+#define JONSWAP_PROFILE 0
+#endif
+
+enum jonswapStage {
+	JONSWAP_STAGE_BIN = 0,      // bin edges
+	JONSWAP_STAGE_AMPS,         // bin integration
+	JONSWAP_STAGE_PADDLE,       // paddle strokes
+	JONSWAP_STAGE_CDF,          // CDF table builds
+	JONSWAP_STAGE_SYNTH,        // time series synthesis
+	JONSWAP_STAGES
+};
+
+enum jonswapCounter {
+	JONSWAP_COUNT_EVALS = 0,    // spectrum evaluations
+	JONSWAP_COUNT_BINS,         // bins generated
+	JONSWAP_COUNT_HOS_SOLVES,   // H/S tables computed
+	JONSWAP_COUNT_HOS_HITS,     // H/S tables found in the cache
+	JONSWAP_COUNT_SAMPLES,      // samples synthesized
+	JONSWAP_COUNTERS
+};
+
+struct jonswapProfileSnapshot {
+	uint64_t calls[JONSWAP_STAGES];
+	double seconds[JONSWAP_STAGES];
+	uint64_t counts[JONSWAP_COUNTERS];
+
+	jonswapProfileSnapshot();
+
+	std::string json() const;
+	void print(std::ostream &out) const;
+};
+
+const char *jonswapStageName(jonswapStage s);
+const char *jonswapCounterName(jonswapCounter c);
+
+// false when compiled without JONSWAP_PROFILE
+bool jonswapProfileEnabled();
+
+// sum over all threads
+jonswapProfileSnapshot jonswapProfileGet();
+
+// zero every record; call while no instrumented code runs
+void jonswapProfileReset();
+
+#if JONSWAP_PROFILE
+#include <chrono>
+
+void jonswapProfileAdd(jonswapCounter c, uint64_t n);
+void jonswapProfileStage(jonswapStage s, uint64_t nanos);
+
+class jonswapProfileScope
+{
+public:
+	explicit jonswapProfileScope(jonswapStage s) : stage(s), start(std::chrono::steady_clock::now()) {}
+	~jonswapProfileScope() {
+		jonswapProfileStage(stage, std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - start).count());
+	}
+
+private:
+	jonswapStage stage;
+	std::chrono::steady_clock::time_point start;
+};
+
+#define JONSWAP_PROFILE_CAT2(a, b) a##b
+#define JONSWAP_PROFILE_CAT(a, b) JONSWAP_PROFILE_CAT2(a, b)
+#define JONSWAP_PROFILE_SCOPE(stage) \
+	jonswapProfileScope JONSWAP_PROFILE_CAT(jonswapProfileScope_, __LINE__)(stage)
+#define JONSWAP_PROFILE_COUNT(counter, n) jonswapProfileAdd(counter, (uint64_t) (n))
+#else
+#define JONSWAP_PROFILE_SCOPE(stage) do {} while (0)
+#define JONSWAP_PROFILE_COUNT(counter, n) do {} while (0)
+#endif
+
+#endif
@@ -0,0 +1,214 @@
+//
+//  jonswapQuad.cpp
+//
+
+#include <math.h>
+#include "jonswapQuad.h"
+#include "jonswapMoments.h"
+
+// nodes evaluated per batch call; small enough to stay in cache
+static const size_t BLOCK_NODES = 4096;
+
+// Gauss-Kronrod 15 point abscissae on [0, 1] (symmetric), odd entries
+// are the 7 point Gauss nodes (QUADPACK qk15)
+static const double XGK[8] = {
+	0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+	0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+	0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+	0.207784955007898467600689403773245, 0.000000000000000000000000000000000
+};
+static const double WGK[8] = {
+	0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+	0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+	0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+	0.204432940075298892414161999234649, 0.209482141084727828012999174891714
+};
+// Gauss 7 point weights of XGK[1], XGK[3], XGK[5], XGK[7]
+static const double WG[4] = {
+	0.129484966168869693270611432679082, 0.279705391489276667901467771423780,
+	0.381830050505118944950369775488975, 0.417959183673469387755102040816327
+};
+static const size_t KRONROD_NODES = 15;
+static const int MAX_DEPTH = 40;
+
+jonswapQuad::jonswapQuad(int order) : nevals(0), precision(JONSWAP_PRECISION_DOUBLE) {
+	setOrder(order);
+}
+
+// Gauss-Legendre nodes and weights by Newton iteration on P_n
+void jonswapQuad::setOrder(int order) {
+	if (order < 1)
+		order = 1;
+	if (order == (int) x.size())
+		return;
+	int n = order;
+	x.assign(n, 0.0);
+	wt.assign(n, 0.0);
+
+	for (int i = 0; i < (n + 1) / 2; i++) {
+		double z = cos(M_PI * (i + 0.75) / (n + 0.5));
+		double pp = 1.0, z1;
+		do {
+			double p1 = 1.0, p2 = 0.0;
+			for (int j = 1; j <= n; j++) {
+				double p3 = p2;
+				p2 = p1;
+				p1 = ((2.0*j - 1.0) * z * p2 - (j - 1.0) * p3) / j;
+			}
+			pp = n * (z * p1 - p2) / (z * z - 1.0);
+			z1 = z;
+			z = z1 - p1 / pp;
+		} while (fabs(z - z1) > 1e-15);
+
+		x[i] = -z;
+		x[n - 1 - i] = z;
+		wt[i] = wt[n - 1 - i] = 2.0 / ((1.0 - z * z) * pp * pp);
+	}
+}
+
+void jonswapQuad::evalBlock(const jonswapEval &S, size_t n) {
+	if (precision == JONSWAP_PRECISION_MIXED) {
+		fnodes.resize(nodes.size());
+		fvals.resize(nodes.size());
+		for (size_t i = 0; i < n; i++)
+			fnodes[i] = (float) nodes[i];
+		S(&fnodes[0], &fvals[0], n);
+		for (size_t i = 0; i < n; i++)
+			vals[i] = fvals[i];
+	} else {
+		S(&nodes[0], &vals[0], n);
+	}
+	nevals += n;
+}
+
+void jonswapQuad::integrate(const jonswapEval &S, const double *edges, size_t nbins, double *area) {
+	size_t m = x.size();
+	size_t binsPerBlock = BLOCK_NODES / m > 0 ? BLOCK_NODES / m : 1;
+	nodes.resize(binsPerBlock * m);
+	vals.resize(binsPerBlock * m);
+	nevals = 0;
+
+	for (size_t b0 = 0; b0 < nbins; b0 += binsPerBlock) {
+		size_t nb = nbins - b0 < binsPerBlock ? nbins - b0 : binsPerBlock;
+
+		for (size_t b = 0; b < nb; b++) {
+			double mid = (edges[b0 + b] + edges[b0 + b + 1]) / 2;
+			double half = (edges[b0 + b + 1] - edges[b0 + b]) / 2;
+			for (size_t k = 0; k < m; k++)
+				nodes[b * m + k] = mid + half * x[k];
+		}
+		evalBlock(S, nb * m);
+
+		for (size_t b = 0; b < nb; b++) {
+			double half = (edges[b0 + b + 1] - edges[b0 + b]) / 2;
+			double sum = 0;
+			for (size_t k = 0; k < m; k++)
+				sum += wt[k] * vals[b * m + k];
+			area[b0 + b] = half * sum;
+		}
+	}
+}
+
+void jonswapQuad::moments(const jonswapEval &S, const double *edges, size_t nbins, double m[5]) {
+	size_t nn = x.size();
+	size_t binsPerBlock = BLOCK_NODES / nn > 0 ? BLOCK_NODES / nn : 1;
+	nodes.resize(binsPerBlock * nn);
+	vals.resize(binsPerBlock * nn);
+	nevals = 0;
+
+	for (int k = 0; k < 5; k++)
+		m[k] = 0;
+	for (size_t b0 = 0; b0 < nbins; b0 += binsPerBlock) {
+		size_t nb = nbins - b0 < binsPerBlock ? nbins - b0 : binsPerBlock;
+
+		// weights folded into vals, so the sum below is one flat loop
+		for (size_t b = 0; b < nb; b++) {
+			double mid = (edges[b0 + b] + edges[b0 + b + 1]) / 2;
+			double half = (edges[b0 + b + 1] - edges[b0 + b]) / 2;
+			for (size_t k = 0; k < nn; k++)
+				nodes[b * nn + k] = mid + half * x[k];
+		}
+		evalBlock(S, nb * nn);
+		for (size_t b = 0; b < nb; b++) {
+			double half = (edges[b0 + b + 1] - edges[b0 + b]) / 2;
+			for (size_t k = 0; k < nn; k++)
+				vals[b * nn + k] *= half * wt[k];
+		}
+
+		jonswapAccumulateMoments(&vals[0], NULL, &nodes[0], nb * nn, m);
+	}
+}
+
+void jonswapQuad::integrateAdaptive(const jonswapEval &S, const double *edges, size_t nbins,
+		double *area, double tol) {
+	const size_t perBlock = BLOCK_NODES / KRONROD_NODES;
+	nodes.resize(perBlock * KRONROD_NODES);
+	vals.resize(perBlock * KRONROD_NODES);
+	nevals = 0;
+
+	active.clear();
+	for (size_t i = 0; i < nbins; i++) {
+		interval iv = { i, edges[i], edges[i + 1], 0 };
+		active.push_back(iv);
+		area[i] = 0;
+	}
+
+	double total = -1;  // unknown until the first pass is done
+	while (!active.empty()) {
+		next.clear();
+		double passTotal = 0;
+
+		for (size_t i0 = 0; i0 < active.size(); i0 += perBlock) {
+			size_t ni = active.size() - i0 < perBlock ? active.size() - i0 : perBlock;
+
+			for (size_t i = 0; i < ni; i++) {
+				const interval &iv = active[i0 + i];
+				double mid = (iv.a + iv.b) / 2;
+				double half = (iv.b - iv.a) / 2;
+				double *nd = &nodes[i * KRONROD_NODES];
+				for (int k = 0; k < 7; k++) {
+					nd[k] = mid - half * XGK[k];
+					nd[14 - k] = mid + half * XGK[k];
+				}
+				nd[7] = mid;
+			}
+			evalBlock(S, ni * KRONROD_NODES);
+
+			for (size_t i = 0; i < ni; i++) {
+				const interval &iv = active[i0 + i];
+				const double *f = &vals[i * KRONROD_NODES];
+				double half = (iv.b - iv.a) / 2;
+
+				double kron = WGK[7] * f[7];
+				double gauss = WG[3] * f[7];
+				for (int k = 0; k < 7; k++) {
+					double pair = f[k] + f[14 - k];
+					kron += WGK[k] * pair;
+					if (k % 2 == 1)
+						gauss += WG[k / 2] * pair;
+				}
+				kron *= half;
+				gauss *= half;
+				passTotal += fabs(kron);
+
+				double err = fabs(kron - gauss);
+				double scale = fabs(kron);
+				if (total > 0 && scale < 1e-12 * total)
+					scale = 1e-12 * total;
+				if (err <= tol * scale || iv.depth >= MAX_DEPTH) {
+					area[iv.bin] += kron;
+				} else {
+					double mid = (iv.a + iv.b) / 2;
+					interval lo = { iv.bin, iv.a, mid, iv.depth + 1 };
+					interval hi = { iv.bin, mid, iv.b, iv.depth + 1 };
+					next.push_back(lo);
+					next.push_back(hi);
+				}
+			}
+		}
+
+		if (total < 0)
+			total = passTotal;
+		active.swap(next);
+	}
+}
@@ -0,0 +1,81 @@
+//
+//  jonswapQuad.h
+//
+//  Integration of the spectrum over frequency bins. Nodes of all bins are
+//  gathered into blocks and evaluated by the batch kernels in one pass, and
+//  every node is evaluated exactly once.
+//
+//  integrate()         - fixed order Gauss-Legendre in every bin
+//  integrateAdaptive() - Gauss-Kronrod G7/K15 per bin, halving only the
+//                        intervals whose error estimate misses the tolerance
+//  moments()           - the moments m0 .. m4 over all bins in the same pass
+//
+//  With JONSWAP_PRECISION_MIXED the nodes are evaluated by the float
+//  kernels and widened, while weights and sums stay in double, so the
+//  result carries the float kernel's relative error (see jonswapKernel.h)
+//  and no float rounding of the sums.
+//
+//  Scratch buffers are kept between calls, so a jonswapQuad that is reused
+//  stops allocating once it has seen its largest problem. One instance must
+//  not be used by two threads at once.
+//
+
+#ifndef JONSWAPQUAD_H
+#define JONSWAPQUAD_H
+
+#include <vector>
+#include "jonswapEval.h"
+
+using std::vector;
+
+enum jonswapPrecision {
+	JONSWAP_PRECISION_DOUBLE = 0,
+	JONSWAP_PRECISION_MIXED     // float evaluation, double accumulation
+};
+
+class jonswapQuad
+{
+public:
+	explicit jonswapQuad(int order = 8);
+
+	// Gauss-Legendre order (nodes per bin) for integrate()
+	void setOrder(int order);
+	int getOrder() const { return (int) x.size(); }
+
+	void setPrecision(jonswapPrecision p) { precision = p; }
+	jonswapPrecision getPrecision() const { return precision; }
+
+	// area[i] = integral of S over [edges[i], edges[i+1]], i < nbins
+	void integrate(const jonswapEval &S, const double *edges, size_t nbins, double *area);
+
+	// Same, refining until each interval's |K15 - G7| <= tol * |K15|.
+	// Intervals whose integral is negligible next to the total are
+	// accepted once their error is below tol * 1e-12 of the total.
+	void integrateAdaptive(const jonswapEval &S, const double *edges, size_t nbins,
+			double *area, double tol);
+
+	// m[k] = sum over the bins of the integral of w^k S, k = 0 .. 4, with
+	// the Gauss-Legendre rule of integrate() and each node evaluated once
+	void moments(const jonswapEval &S, const double *edges, size_t nbins, double m[5]);
+
+	// spectrum evaluations done by the last call
+	size_t evaluations() const { return nevals; }
+
+private:
+	struct interval {
+		size_t bin;
+		double a, b;
+		int depth;
+	};
+
+	vector<double> x, wt;          // Gauss-Legendre nodes and weights on [-1, 1]
+	vector<double> nodes, vals;    // one block of nodes and spectrum values
+	vector<float> fnodes, fvals;   // the same for mixed precision
+	vector<interval> active, next; // adaptive work lists
+	size_t nevals;
+	jonswapPrecision precision;
+
+	void evalBlock(const jonswapEval &S, size_t n);
+};
+
+#endif
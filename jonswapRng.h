@@ -0,0 +1,55 @@
+//
+//  jonswapRng.h
+//
+//  Small seedable random stream (SplitMix64). The whole state is one
+//  64 bit counter, so output k of a stream is a pure function of its key
+//  and k. stream(seed, index) gives every realization of an ensemble its
+//  own key, so results don't depend on which thread ran it.
+//
+
+#ifndef JONSWAPRNG_H
+#define JONSWAPRNG_H
+
+#include <stdint.h>
+#include <math.h>
+
+class jonswapRng
+{
+public:
+	explicit jonswapRng(uint64_t seed = 0) : state(seed) {}
+
+	void seed(uint64_t s) { state = s; }
+
+	// key of stream index under seed
+	static uint64_t streamSeed(uint64_t seed, uint64_t index) {
+		return mix(mix(seed) ^ (index + 0x9e3779b97f4a7c15ULL));
+	}
+	static jonswapRng stream(uint64_t seed, uint64_t index) {
+		return jonswapRng(streamSeed(seed, index));
+	}
+
+	uint64_t next() { return mix(state += 0x9e3779b97f4a7c15ULL); }
+
+	// uniform double in [0, 1)
+	double uniform() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+	double operator()() { return uniform(); }
+
+	// standard normal deviate (Box-Muller, one value per call)
+	double normal() {
+		double u1 = 1.0 - uniform();
+		double u2 = uniform();
+		return sqrt(-2.0 * log(u1)) * cos(2 * M_PI * u2);
+	}
+
+private:
+	uint64_t state;
+
+	static uint64_t mix(uint64_t z) {
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		return z ^ (z >> 31);
+	}
+};
+
+#endif
@@ -0,0 +1,72 @@
+//
+//  jonswapSolve.cpp
+//
+
+#include "jonswapSolve.h"
+#include "jonswapSpec.h"
+#include "jonswapEval.h"
+#include "jonswapMoments.h"
+
+jonswapSpec jonswapSpecParams::make() const {
+	return jonswapSpec(alpha, wp, wmax, gamma, s1, s2);
+}
+
+jonswapParamSolver::jonswapParamSolver(double s1, double s2, double wmaxRatio, double gammaMax,
+		size_t nodes)
+	: s1(s1), s2(s2), ratio(wmaxRatio), g(jonswapSpec(1, 1, wmaxRatio, 1, s1, s2).getG()) {
+	if (nodes < 4)
+		nodes = 4;
+	u1 = log(gammaMax > 1 ? gammaMax : 1 + 1e-9);
+	du = u1 / (nodes - 1);
+	I.resize(nodes);
+	for (size_t i = 0; i < nodes; i++)
+		I[i] = integrate(exp(i * du));
+}
+
+// I for alpha = 1, wp = 1
+double jonswapParamSolver::integrate(double gamma) const {
+	jonswapSpec unit(1, 1, ratio, gamma, s1, s2);
+	double ug = unit.getG();
+	return jonswapSpectrumMoments(jonswapEval(unit), ratio).m0 / (ug * ug);
+}
+
+// cubic through the four nodes around log(gamma)
+double jonswapParamSolver::normalization(double gamma) const {
+	double u = log(gamma);
+	if (!(u >= 0 && u <= u1))
+		return integrate(gamma);
+
+	double t = u / du;
+	size_t last = I.size() - 1;
+	size_t i = (size_t) t;
+	size_t i0 = i < 1 ? 0 : i + 2 > last ? last - 3 : i - 1;
+	double x = t - i0;
+	const double *y = &I[i0];
+	return -y[0] * (x - 1) * (x - 2) * (x - 3) / 6 + y[1] * x * (x - 2) * (x - 3) / 2
+		- y[2] * x * (x - 1) * (x - 3) / 2 + y[3] * x * (x - 1) * (x - 2) / 6;
+}
+
+jonswapSpecParams jonswapParamSolver::solve(const jonswapSeaState &s) const {
+	jonswapSpecParams p;
+	p.wp = 2 * M_PI / s.Tp;
+	p.wmax = ratio * p.wp;
+	p.gamma = s.gamma;
+	p.s1 = s1;
+	p.s2 = s2;
+	double wp2 = p.wp * p.wp;
+	p.alpha = s.Hs * s.Hs / 16 * wp2 * wp2 / (g * g * normalization(s.gamma));
+	return p;
+}
+
+void jonswapParamSolver::solve(const jonswapSeaState *s, size_t n, jonswapSpecParams *out) const {
+	for (size_t i = 0; i < n; i++)
+		out[i] = solve(s[i]);
+}
+
+jonswapSpecParams jonswapParamSolver::refine(const jonswapSpecParams &p, double Hs) const {
+	jonswapSpecParams r = p;
+	double m0 = jonswapSpectrumMoments(jonswapEval(p.make()), p.wmax).m0;
+	if (m0 > 0)
+		r.alpha *= Hs * Hs / 16 / m0;
+	return r;
+}
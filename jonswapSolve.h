@@ -0,0 +1,69 @@
+//
+//  jonswapSolve.h
+//
+//  Constructor parameters from a sea state given as (Hs, Tp, gamma).
+//  wp = 2 pi / Tp, and with x = w / wp the energy of the spectrum is
+//
+//      m0 = alpha g^2 wp^-4 I(gamma),
+//      I(gamma) = integral from 0 to xmax of x^-5 exp(-1.2 x^-4) gamma^r(x) dx
+//
+//  for fixed s1, s2 and xmax = wmax / wp. The solver tabulates I on a
+//  uniform grid in log(gamma) once, so each solve is a cubic interpolation
+//  and one division: alpha = (Hs^2 / 16) wp^4 / (g^2 I(gamma)). Gammas
+//  outside the table are integrated directly. refine() does the Newton
+//  step on m0 against a full integration, which is exact in one step since
+//  m0 is linear in alpha.
+//
+
+#ifndef JONSWAPSOLVE_H
+#define JONSWAPSOLVE_H
+
+#include <stddef.h>
+#include <math.h>
+#include <vector>
+
+using std::vector;
+
+class jonswapSpec;
+
+struct jonswapSeaState {
+	double Hs, Tp, gamma;
+};
+
+// arguments of jonswapSpec(alpha, wp, wmax, gamma, s1, s2)
+struct jonswapSpecParams {
+	double alpha, wp, wmax, gamma, s1, s2;
+
+	jonswapSpec make() const;
+};
+
+class jonswapParamSolver
+{
+public:
+	// wmaxRatio = wmax / wp, 33 / (2 pi) as in jonswapSpec(vel10, F); the
+	// table covers 1 <= gamma <= gammaMax
+	explicit jonswapParamSolver(double s1 = 0.07, double s2 = 0.09,
+			double wmaxRatio = 33 / (2 * M_PI), double gammaMax = 20, size_t nodes = 129);
+
+	jonswapSpecParams solve(const jonswapSeaState &s) const;
+
+	// n sea states at once
+	void solve(const jonswapSeaState *s, size_t n, jonswapSpecParams *out) const;
+
+	// I(gamma), from the table when it covers gamma
+	double normalization(double gamma) const;
+
+	// alpha corrected so that the spectrum of p, integrated on [0, wmax],
+	// has exactly this Hs
+	jonswapSpecParams refine(const jonswapSpecParams &p, double Hs) const;
+
+private:
+	double s1, s2, ratio;
+	double g;            // gravity of the spectra solved for, jonswapSpec::getG()
+	double u1, du;       // log(gamma) of the last node, node spacing
+	vector<double> I;    // I at log(gamma) = i du
+
+	double integrate(double gamma) const;
+};
+
+#endif
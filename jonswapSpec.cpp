@@ -21,6 +21,13 @@
 #include <math.h>
 #include <float.h>
 #include "jonswapSpec.h"
+#include "jonswapEval.h"
+#include "jonswapQuad.h"
+#include "jonswapCDF.h"
+#include "jonswapMoments.h"
+#include "jonswapPipeline.h"
+#include "jonswapLog.h"
+#include "jonswapProfile.h"
 
 
 // Default constructor uses pre-defined jonswap parameters
@@ -42,6 +49,8 @@ jonswapSpec::jonswapSpec(double alpha, double wp, double wmax, double gamma, dou
 	this->vel10 = 0.0;
 	
 	g = 9.81;
+	kp = jonswapMakeKernelParams(alpha, wp, gamma, s1, s2, g);
+	initStages();
 }
 
 // Initializer that calculates alpha and wp based on:
@@ -61,6 +70,111 @@ jonswapSpec::jonswapSpec(double vel10, double F) {
 	gamma = 3.3;
 	s1 = 0.7;
 	s2 = 0.9;
+	kp = jonswapMakeKernelParams(alpha, wp, gamma, s1, s2, g);
+	initStages();
+}
+
+void jonswapSpec::initStages() {
+	method = AMPS_NONE;
+	nmems = 0;
+	tol = 0;
+	depth = 0;
+	dirty = 0;
+	peaks.n = 0;
+}
+
+void jonswapSpec::setParams() {
+	kp = jonswapMakeKernelParams(alpha, wp, gamma, s1, s2, g);
+	if (peaks.n)
+		jonswapSetPeak(peaks, 0, kp);
+	dirty |= DIRTY_AMPS | DIRTY_PADDLE;
+}
+
+void jonswapSpec::setPeaks(const jonswapPeakParams &m) {
+	peaks = m;
+	if (peaks.n < 2)
+		peaks.n = 0;
+	else
+		jonswapSetPeak(peaks, 0, kp);
+	dirty |= DIRTY_AMPS | DIRTY_PADDLE;
+}
+
+// S is proportional to alpha, so amps scale by the ratio and paddle amps
+// by its square root; nothing is integrated again
+void jonswapSpec::setAlpha(double a) {
+	if (a == alpha)
+		return;
+	double ratio = a / alpha;
+	alpha = a;
+	if (peaks.n) {
+		setParams();
+		return;
+	}
+	kp = jonswapMakeKernelParams(alpha, wp, gamma, s1, s2, g);
+	scaleStages(ratio);
+}
+
+void jonswapSpec::scaleStages(double ratio) {
+	if (!(dirty & DIRTY_AMPS))
+		for (size_t i = 0; i < bins.amps.size(); i++)
+			bins.amps[i] *= ratio;
+	if (!(dirty & DIRTY_PADDLE)) {
+		double root = sqrt(ratio);
+		for (size_t i = 0; i < bins.paddleAmps.size(); i++)
+			bins.paddleAmps[i] *= root;
+	}
+}
+
+void jonswapSpec::setWp(double w) {
+	if (w == wp)
+		return;
+	wp = w;
+	setParams();
+}
+
+void jonswapSpec::setGamma(double gam) {
+	if (gam == gamma)
+		return;
+	gamma = gam;
+	setParams();
+}
+
+void jonswapSpec::setSigmas(double sig1, double sig2) {
+	if (sig1 == s1 && sig2 == s2)
+		return;
+	s1 = sig1;
+	s2 = sig2;
+	setParams();
+}
+
+void jonswapSpec::setDepth(double h) {
+	if (h == depth)
+		return;
+	depth = h;
+	dirty |= DIRTY_PADDLE;
+}
+
+void jonswapSpec::setPaddleModel(const jonswapPaddleModel &model) {
+	if (model == transfer.getModel())
+		return;
+	transfer.setModel(model);
+	dirty |= DIRTY_PADDLE;
+}
+
+// Redo the invalidated stages that have been computed before
+void jonswapSpec::refresh() {
+	if ((dirty & DIRTY_AMPS) && method != AMPS_NONE)
+		computeAmps();
+	if ((dirty & DIRTY_PADDLE) && depth > 0 && !(dirty & DIRTY_AMPS))
+		computePaddleAmps();
+}
+
+// Nothing left for refresh() to do. Stages never computed (no calcBinAmps*
+// yet, or no depth) stay stale without counting.
+bool jonswapSpec::isFresh() const {
+	if ((dirty & DIRTY_AMPS) && method != AMPS_NONE)
+		return false;
+	return !((dirty & DIRTY_PADDLE) && depth > 0 && !(dirty & DIRTY_AMPS));
 }
 
 jonswapSpec::~jonswapSpec() {
@@ -70,103 +184,137 @@ jonswapSpec::~jonswapSpec() {
 
 // Calculate amplitude of jonswap spectrum for specific angular velocity
 double jonswapSpec::getamp(double w) {
-	
-	// Compute intermediate values:
-	double s = (w > wp ? s2 : s1); // set sigma 
-	double dw = w - wp;
-	double rexp_denom = s * wp ;
-	double rexp = -pow(dw/rexp_denom, 2) / 2.0;
-	double r = exp(rexp);
-	
-	double gammaR = pow(gamma,r);
-	
-	double jdistExp = -1.2 * pow(wp/w,4);
-	double c = alpha * g * g * pow(w, -5); // alpha g^2/w^5
-	
-	return c * exp(jdistExp) * gammaR;
-	
+	JONSWAP_PROFILE_COUNT(JONSWAP_COUNT_EVALS, 1);
+	return peaks.n ? jonswapPeaksFormula(peaks, w) : jonswapFormula(kp, w);
 }
 
 // Calculate amplitudes of jonswap spectrum for a vector of angular velocities
 vector<double> jonswapSpec::getamp(vector<double> w) {
-	vector<double> amps;
-	vector<double>::iterator it;
-	double amp;
-	
-	for ( it = w.begin()+1; it != w.end(); ++it) {      //RAD: +1
-		amp = getamp(*it);
-		amps.push_back(amp);
-	}
+	if (w.size() < 2)
+		return vector<double>();
+
+	vector<double> amps(w.size() - 1);
+	getamp(&w[1], &amps[0], amps.size());      //RAD: +1
 	return amps;
 }
 
+// Calculate amplitudes for n angular velocities into amp, using the fastest
+// batch kernel this cpu supports. amp must have room for n values.
+void jonswapSpec::getamp(const double *w, double *amp, size_t n) const {
+	JONSWAP_PROFILE_COUNT(JONSWAP_COUNT_EVALS, n);
+	if (peaks.n)
+		jonswapBatchPeaks(peaks, w, amp, n);
+	else
+		jonswapBatch(kp, w, amp, n);
+}
+
+void jonswapSpec::getamp(const float *w, float *amp, size_t n) const {
+	JONSWAP_PROFILE_COUNT(JONSWAP_COUNT_EVALS, n);
+	if (peaks.n)
+		jonswapBatchPeaks(peaks, w, amp, n);
+	else
+		jonswapBatch(kp, w, amp, n);
+}
+
 // Randomly generate boundaries for N bins and calculate their center frequency
 void jonswapSpec::bin(int n) {
-	
+	JONSWAP_PROFILE_SCOPE(JONSWAP_STAGE_BIN);
 #if USE_CPP11
 	random_device gen;
 	normal_distribution<double> distribution(wp, wp/2);
-	//auto bound = std::bind(distribution, gen);
-	cout << "Bounds (Normal Dist): " <<endl;
-	cout << "mu " << wp << ", sigma " << wp/2 << endl;
-	double bound;
-	while (bounds.size() < n-1) {
-		bound = distribution(gen);
-		if(bound > 0 && bound < wmax) {
-			bounds.insert(bound);
-		}
-		
-	}
-	for(auto b_it = bounds.begin(); b_it != bounds.end(); ++b_it) {
-		cout << *b_it << endl;
-	}
+	struct {
+		random_device *gen;
+		normal_distribution<double> *distribution;
+		double operator()() { return (*distribution)(*gen); }
+	} draw = { &gen, &distribution };
+
+	JONSWAP_LOG(JONSWAP_LOG_INFO, "Bounds (Normal Dist): ");
+	JONSWAP_LOG(JONSWAP_LOG_INFO, "mu " << wp << ", sigma " << wp/2);
+	jonswapNormalEdges(wmax, n, draw, bins.edges);
 #else
 	srand(time(NULL));
-	double bound;
-	double range = 0.4 * (wmax / n); // range is +- 2.5% of bin width 
-	double offset = -wmax / (2*n); // center range around 0
-	
-	cout<<"Bounds (Uniform Generator): " <<endl;
-	
-	for (int i = 1; i < n; i++) {
-		bound = i * wmax/n + ((double) rand() / RAND_MAX) * range + offset;
-		cout <<bound <<endl;
-		bounds.insert(bound);
-	}
+	struct {
+		double operator()() { return (double) rand() / RAND_MAX; }
+	} uniform;
+
+	JONSWAP_LOG(JONSWAP_LOG_INFO, "Bounds (Uniform Generator): ");
+	jonswapJitterEdges(wmax, n, uniform, bins.edges);
 #endif
+	setBins();
+}
 
-	set<double>::iterator it;
-	
+// Same as bin(n), but reproducible: the bounds come from a jonswapRng
+// stream seeded with seed instead of the global rand() or random_device
+void jonswapSpec::bin(int n, uint64_t seed) {
+	JONSWAP_PROFILE_SCOPE(JONSWAP_STAGE_BIN);
+	jonswapRng rng(seed);
+#if USE_CPP11
+	struct {
+		jonswapRng *rng;
+		double wp;
+		double operator()() { return wp + wp/2 * rng->normal(); }
+	} draw = { &rng, wp };
+
+	JONSWAP_LOG(JONSWAP_LOG_INFO, "Bounds (Normal Dist): ");
+	JONSWAP_LOG(JONSWAP_LOG_INFO, "mu " << wp << ", sigma " << wp/2);
+	jonswapNormalEdges(wmax, n, draw, bins.edges);
+#else
+	JONSWAP_LOG(JONSWAP_LOG_INFO, "Bounds (Uniform Generator): ");
+	jonswapJitterEdges(wmax, n, rng, bins.edges);
+#endif
+	setBins();
+}
 
-	/*it = bounds.begin();
-	cout << "bounds: 0 - " << *next(it);
-	wc.push_back(*next(it)/2);
-	cout << ":\twc = " << *next(it)/2 << endl;*/
+void jonswapSpec::bin(int n, uint64_t seed, const jonswapEdgeOptions &o) {
+	JONSWAP_PROFILE_SCOPE(JONSWAP_STAGE_BIN);
+	jonswapRng rng(seed);
+	if (o.spacing == JONSWAP_SPACING_ENERGY && !o.cdf) {
+		jonswapCDF cdf(*this);
+		jonswapEdgeOptions own = o;
+		own.cdf = &cdf;
+		jonswapEdges(own, wmax, n, rng, bins.edges);
+	} else {
+		jonswapEdges(o, wmax, n, rng, bins.edges);
+	}
+	setBins();
+}
 
-	for (it = bounds.begin(); it != prev(bounds.end()); ++it) {
-		double currBound = *it;
-		double nextBound = *next(it);
+int jonswapSpec::binEnergy(double maxEnergy, double maxWidth) {
+	JONSWAP_PROFILE_SCOPE(JONSWAP_STAGE_BIN);
+	jonswapCDF cdf(*this);
+	int n = jonswapEnergyEdges(cdf, maxEnergy, maxWidth, bins.edges);
+	JONSWAP_LOG(JONSWAP_LOG_INFO, "Bounds (Equal Energy): " << n << " bins");
+	setBins();
+	return n;
+}
 
-		//cout << "currBound: "<< currBound << "\tnextBound: " << nextBound << endl;
+// Centers and widths of freshly generated edges; drops old amps
+void jonswapSpec::setBins() {
+	const vector<double> &edges = bins.edges;
+	JONSWAP_PROFILE_COUNT(JONSWAP_COUNT_BINS, edges.size() - 1);
 
-		if (it == bounds.begin()) {
-			cout << "bounds: 0 - " << currBound;
-			wc.push_back(currBound/2);
-			cout <<":\twc = " << currBound/2 << endl;
-		}
-		cout << "bounds: " << currBound << " - " << nextBound;
-		wc.push_back((currBound + nextBound)/2);
-		cout << ":\twc = " << (currBound + nextBound)/2 << endl;
+	for (size_t i = 1; JONSWAP_LOG_ON(JONSWAP_LOG_TRACE) && i + 1 < edges.size(); ++i) {
+		JONSWAP_LOG(JONSWAP_LOG_TRACE, edges[i]);
+	}
+
+	bins.setCenters();
+	bins.amps.clear();
+	bins.paddleAmps.clear();
+	dirty |= DIRTY_AMPS | DIRTY_PADDLE;
+
+	for (size_t i = 0; JONSWAP_LOG_ON(JONSWAP_LOG_TRACE) && i < bins.size(); i++) {
+		JONSWAP_LOG(JONSWAP_LOG_TRACE, "bounds: " << edges[i] << " - " << edges[i + 1]
+			<< ":\twc = " << bins.wc[i]);
 	}
-	
-	cout << "bounds: " << *prev(bounds.end()) << " - " << wmax;
-	wc.push_back((*prev(bounds.end()) + wmax)/2);
-	cout << ":\twc = " << (*prev(bounds.end()) + wmax)/2 << endl;
 }
 
 // Calculate alpha based on wind speed and fetch
 // Helper function for automatic parameter calculation constructor
 double jonswapSpec::calcAlpha() {
+	return calcAlpha(vel10, F, g);
+}
+
+double jonswapSpec::calcAlpha(double vel10, double F, double g) {
 	double velDivF = vel10/F;
 
 	double tmp = velDivF * vel10 / g;
@@ -177,6 +325,10 @@ double jonswapSpec::calcAlpha() {
 // Calculate peak angular velocity of jonswap spectrum from wind speed and fetch
 // Helper function for automatic parameter calculation constructor
 double jonswapSpec::calcWp() {
+	return calcWp(vel10, F, g);
+}
+
+double jonswapSpec::calcWp(double vel10, double F, double g) {
 	double velxF = vel10*F;
 	double g2 = g*g;
 
@@ -184,111 +336,119 @@ double jonswapSpec::calcWp() {
 }
 
 
-// Integrate jonswap spectrum using discrete trapezoidal integration to find amp of bin
-vector <double> jonswapSpec::calcBinAmps (int nmems)   {
-	set<double>::iterator bounds_it = bounds.begin();
-	double binWidth;
-	double binArea, area;
-
-	double startx, dx;
-	double sidea, sideb, slice_area;
-
-	area = 0;
-	binArea = 0;
-
-	binWidth = *bounds_it;
-	dx = binWidth/(nmems+1); // start at dx instead of 0 so we need an extra step
-	startx = dx;
+// Integrate jonswap spectrum over each bin with nmems point Gauss-Legendre
+// quadrature to find amp of bin
+const vector <double> &jonswapSpec::calcBinAmps (int nmems)   {
+	method = AMPS_GAUSS;
+	this->nmems = nmems;
+	computeAmps();
+	return logBinAmps();
+}
 
-	cout << "bounds: " << startx << " - " << startx + binWidth;
+// Same as calcBinAmps, but each bin is refined adaptively until its relative
+// error estimate is below tol
+const vector <double> &jonswapSpec::calcBinAmpsAdaptive (double tol)   {
+	method = AMPS_ADAPTIVE;
+	this->tol = tol;
+	computeAmps();
+	return logBinAmps();
+}
 
-	for(double i = startx; i < startx+binWidth; i += dx) {
-		sidea = this->getamp(i);
-		sideb = this->getamp(i + dx);
+// Bin amps from a cumulative energy table of this spectrum, so each bin
+// costs two table lookups instead of an integration. Lazy recomputation
+// after a parameter change builds a new default table.
+const vector <double> &jonswapSpec::calcBinAmps (const jonswapCDF &cdf)   {
+	method = AMPS_CDF;
+	computeAmps(&cdf);
+	return logBinAmps();
+}
 
-		slice_area = dx*(sidea + sideb)/2;
-		binArea += slice_area;
+void jonswapSpec::computeAmps(const jonswapCDF *cdf) {
+	JONSWAP_PROFILE_SCOPE(JONSWAP_STAGE_AMPS);
+	bins.amps.resize(bins.size());
+	dirty = (dirty & ~DIRTY_AMPS) | DIRTY_PADDLE;
+	if (!bins.size())
+		return;
+
+	if (method == AMPS_GAUSS) {
+		jonswapQuad quad(nmems);
+		jonswapBinAmps(jonswapEval(*this), quad, bins);
+		return;
 	}
+	if (method == AMPS_ADAPTIVE) {
+		jonswapQuad quad;
+		quad.integrateAdaptive(jonswapEval(*this), &bins.edges[0], bins.size(), &bins.amps[0], tol);
+	} else if (cdf) {
+		cdf->binEnergies(&bins.edges[0], bins.size(), &bins.amps[0]);
+	} else {
+		jonswapCDF(*this).binEnergies(&bins.edges[0], bins.size(), &bins.amps[0]);
+	}
+	jonswapAreasToAmps(bins);
+}
 
-	amps.push_back(binArea);
-	area += binArea;
-	cout << "\tbinArea = " << binArea << endl;
-
-	for (bounds_it = bounds.begin(); bounds_it != bounds.end(); ++bounds_it) {
-		binArea = 0;
-
-		if (bounds_it == prev(bounds.end())) {
-			startx = *bounds_it;
-			binWidth = wmax - startx;
-			dx = binWidth/nmems;
-		} else {
-			startx = *bounds_it;
-			binWidth = *next(bounds_it) - startx;
-			dx = binWidth/nmems;
-		}
+jonswapStats jonswapSpec::moments() const {
+	return jonswapSpectrumMoments(jonswapEval(*this), wmax);
+}
 
-		cout << "bounds: " << startx << " - " << startx + binWidth;
+jonswapStats jonswapSpec::binMoments() {
+	return jonswapBinMoments(getBinData());
+}
+
+jonswapStats jonswapSpec::binMoments() const {
+	return jonswapBinMoments(getBinData());
+}
 
-		for(double i = startx; i < startx+binWidth; i += dx) {
-			sidea = this->getamp(i);
-			sideb = this->getamp(i + dx);
+double jonswapSpec::setHs(double Hs, bool fromBins) {
+	double m0 = fromBins ? binMoments().m0 : moments().m0;
+	if (!(m0 > 0 && Hs > 0))
+		return alpha;
+	double ratio = (Hs * Hs / 16) / m0;
+	alpha *= ratio;
+	kp = jonswapMakeKernelParams(alpha, wp, gamma, s1, s2, g);
+	for (size_t k = 0; k < peaks.n; k++)
+		peaks.c[k] *= ratio;
+	if (peaks.n)
+		jonswapSetPeak(peaks, 0, kp);
+	scaleStages(ratio);
+	return alpha;
+}
 
-			slice_area = dx*(sidea + sideb)/2;
-			binArea += slice_area;
+// Log bin amps and the total energy m0
+const vector<double> &jonswapSpec::logBinAmps() const {
+	if (JONSWAP_LOG_ON(JONSWAP_LOG_INFO)) {
+		double total = 0;
+		for (size_t i = 0; i < bins.size(); i++) {
+			JONSWAP_LOG(JONSWAP_LOG_TRACE, "bounds: " << bins.edges[i] << " - " << bins.edges[i + 1]
+				<< "\tbinArea = " << bins.amps[i] * bins.width[i]);
+			total += bins.amps[i] * bins.width[i];
 		}
-		amps.push_back(binArea/binWidth);
-		area += binArea/binWidth;
-		cout << "\tbinArea = " << binArea/binWidth << endl;
+		JONSWAP_LOG(JONSWAP_LOG_INFO, "finished calculating areas... total area is: " << total);
 	}
-	cout << "finished calculating areas... total area is: " << area << endl;
-	return amps;
+	return bins.amps;
 }
 
 
 
 // calculate actual paddle stokes as a function of center frequency using linear wave theory
-vector<double> jonswapSpec::calcPaddleAmps(double h) {
-
-	vector<double>::iterator iamps = amps.begin();
-	vector<double>::iterator wc_it;
-	set<double>::iterator bounds_it = bounds.begin();
-	bool piston = false;
-	double HoS;
-	double binWidth;
-
-	for (wc_it = wc.begin(); wc_it !=wc.end(); ++wc_it) {
-		if (wc_it == prev(wc.end())) {
-			binWidth = wmax - *bounds_it;
-			cout << "wc " << *wc_it << ", lb " << *bounds_it << ", ub " << wmax << ", iamp " << *iamps;
-		} else if (wc_it == wc.begin()) {
-			binWidth = *bounds_it;
-			cout << "wc " << *wc_it << ", lb 0, ub " << *bounds_it << ", iamp " << *iamps;
-		} else {
-			binWidth = (*next(bounds_it) -*bounds_it);
-			cout << "wc " << *wc_it << ", lb " << *bounds_it << ", ub " << *next(bounds_it) << ", iamp " << *iamps;
-			bounds_it++;
-		}
+const vector<double> &jonswapSpec::calcPaddleAmps(double h) {
+	depth = h;
+	if ((dirty & DIRTY_AMPS) && method != AMPS_NONE)
+		computeAmps();
+	computePaddleAmps();
+	return bins.paddleAmps;
+}
 
-		double k0 = (*wc_it)*(*wc_it)/9.81;	  //k0= wc^2/g
-		double kh = k0*h*pow(1.0-exp(-(pow(k0*h, 1.25))),-.4);
-		//cout <<"wc  "<< *wc_it << ", k0 " << k0 <<", kh " <<kh;
-
-		double tempAmp=sqrt(*iamps*binWidth*2);
-		if ( piston ) {
-			HoS= 2*(cosh(2*kh)-1)/(sinh(2*kh) + 2*kh);
-			cout<< ", Piston Wavemaker" <<endl;
-		} else {
-			HoS= 4*(sinh(kh)/kh)*(kh*sinh(kh)-cosh(kh)+1)/(sinh(2*kh)+2*kh);
-			cout<< ", Flap Wavemaker" ;
-		}
-		tempAmp = tempAmp/HoS;
-		cout <<", PaddleAmp " << tempAmp <<endl;
-		paddleAmps.push_back(tempAmp/HoS);
+void jonswapSpec::computePaddleAmps() {
+	JONSWAP_PROFILE_SCOPE(JONSWAP_STAGE_PADDLE);
+	transfer.setFrequencies(bins.wc);
+	const vector<double> &HoS = transfer.HoS(depth);
+	jonswapPaddleAmps(bins, HoS.empty() ? NULL : &HoS[0]);
+	dirty &= ~DIRTY_PADDLE;
 
- 	   //cout <<*iamps<<", " << binWidth<<", "<< sqrt(*iamps*binWidth*2)<<endl;
-		iamps++;
+	for (size_t i = 0; JONSWAP_LOG_ON(JONSWAP_LOG_TRACE) && i < bins.paddleAmps.size(); i++) {
+		JONSWAP_LOG(JONSWAP_LOG_TRACE, "wc " << bins.wc[i] << ", lb " << bins.edges[i] << ", ub " << bins.edges[i + 1]
+			<< ", iamp " << bins.amps[i] << ", " << jonswapPaddleName(transfer.getModel().type) << " wavemaker, PaddleAmp " << bins.paddleAmps[i]);
 	}
-	return paddleAmps;
 }
 
 
@@ -304,10 +464,10 @@ ostream &operator<<(ostream &output, const jonswapSpec & jonswap) {
 		output << "vel10\t: " << jonswap.vel10 << endl
 		<< "F\t: " << jonswap.F << endl;
 	}
-	if (jonswap.amps.size()) {
-		output << "Nbins\t: " << jonswap.bounds.size() + 1 << endl;
-		output << "Amps\t: [ 1 x " << jonswap.amps.size() << " ]\n";
-		output << "W_c\t: [ 1 x " << jonswap.wc.size() << " ]\n";
+	if (jonswap.bins.amps.size()) {
+		output << "Nbins\t: " << jonswap.bins.size() << endl;
+		output << "Amps\t: [ 1 x " << jonswap.bins.amps.size() << " ]\n";
+		output << "W_c\t: [ 1 x " << jonswap.bins.wc.size() << " ]\n";
 	}
 
 	return output;
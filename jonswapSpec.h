@@ -3,33 +3,35 @@
 
 #define USE_CPP11 0
 
+// Library version. It is part of every jonswapCache key, so bump it whenever
+// the bins, amps or paddle amps computed for a configuration change.
+#define JONSWAP_VERSION "1.1"
+
 #include <vector>
-#include <set>
-#include <iterator>
+#include <algorithm>
 #include <iostream>
 #include <stdlib.h>
 #include <cmath>
 #include <time.h>
+#include <stdint.h>
+#include <assert.h>
+#include "jonswapKernel.h"
+#include "jonswapBins.h"
+#include "jonswapPaddle.h"
+#include "jonswapEdges.h"
 
 using std::ostream;
 using std::cout;
 using std::endl;
 using std::vector;
-using std::set;
+
+class jonswapCDF;
+struct jonswapStats;
 
 #if USE_CPP11
 #include <random>
 using std::random_device;
 using std::normal_distribution;
-#else
-template<class InputIterator> InputIterator next(InputIterator it) {
-	InputIterator tmp = it;
-	return ++tmp;
-}
-template<class InputIterator> InputIterator prev(InputIterator it) {
-	InputIterator tmp = it;
-	return --tmp;
-}
 #endif
 
 class jonswapSpec
@@ -41,35 +43,140 @@ public:
 	jonswapSpec(double vel10, double F);
 	double getamp(double w);
 	void bin(int n);
+	void bin(int n, uint64_t seed);
+	// O(n) edges without rejection, see jonswapEdges.h. Energy spacing
+	// without o.cdf builds a CDF table of this spectrum.
+	void bin(int n, uint64_t seed, const jonswapEdgeOptions &o);
+	// Error bounded equal energy bins (jonswapEnergyEdges); the bin count
+	// follows from the bounds and is returned
+	int binEnergy(double maxEnergy, double maxWidth = 0);
+    
+    // bin edges, 0 and wmax included
+    const vector<double> &getBins() const { return bins.edges; }
+    
+    const vector<double> &calcBinAmps(int integ_interval);
+    
+    const vector<double> &calcBinAmpsAdaptive(double tol);
+    
+    const vector<double> &calcBinAmps(const jonswapCDF &cdf);
+    
+    // A setter or bin() only marks the amps and paddle amps stale; refresh()
+    // recomputes them with the method of the last calcBinAmps* and the depth
+    // of the last calcPaddleAmps/setDepth. The non-const getters refresh
+    // first. The const ones never write, so threads may share a const
+    // jonswapSpec, and assert that the owner has refreshed it.
+    void refresh();
+    bool isFresh() const;
+    
+    const vector<double> &getAmps() { refresh(); return bins.amps; }
+    const vector<double> &getAmps() const { assert(isFresh()); return bins.amps; }
+    
+    const vector<double> &getWCs() const { return bins.wc; }
+    
+    const vector<double> &getWidths() const { return bins.width; }
     
-    set<double> getBins() { return bounds; }
+    const vector<double> &getPaddleAmps() { refresh(); return bins.paddleAmps; }
+    const vector<double> &getPaddleAmps() const { assert(isFresh()); return bins.paddleAmps; }
     
-    vector<double> calcBinAmps(int integ_interval);
+    // all bin arrays at once
+    const jonswapBins &getBinData() { refresh(); return bins; }
+    const jonswapBins &getBinData() const { assert(isFresh()); return bins; }
     
-  //  set<double> getAmps() { return amps; }
+    double getWmax() const { return wmax; }
+    double getAlpha() const { return alpha; }
+    double getWp() const { return wp; }
+    double getGamma() const { return gamma; }
+    double getS1() const { return s1; }
+    double getS2() const { return s2; }
+    double getVel10() const { return vel10; }
+    double getF() const { return F; }
+    double getG() const { return g; }
+    double getDepth() const { return depth; }
     
-    vector<double> getWCs(){ return wc; }
+    // Parameter changes only invalidate the stages they affect: alpha
+    // rescales the amps in place (redoes them for a composite spectrum,
+    // whose shape it changes), wp, gamma, s1 and s2 keep the bin edges
+    // and redo the amps, and the depth or paddle model redo only the paddle
+    // transfer (with cached H/S per depth)
+    void setAlpha(double alpha);
+    void setWp(double wp);
+    void setGamma(double gamma);
+    void setSigmas(double s1, double s2);
+    void setDepth(double h);
     
-    double getWmax() { return wmax; }
+    // Moments and statistics (jonswapMoments.h) of the spectrum on
+    // [0, wmax], or of the bins as the paddle reproduces them (refreshed
+    // first, as by getBinData)
+    jonswapStats moments() const;
+    jonswapStats binMoments();
+    jonswapStats binMoments() const;
+    
+    // Rescale alpha so that Hs = 4 sqrt(m0) of the spectrum, or of the
+    // bins, hits the target. Amps and paddle amps are scaled in place as
+    // by setAlpha, without integrating again; all peaks of a composite
+    // spectrum are scaled together. Returns the new alpha.
+    double setHs(double Hs, bool fromBins = false);
+    
+    // spectrum invariants, see jonswapEval for a shareable evaluator
+    const jonswapKernelParams &getKernelParams() const { return kp; }
+    
+    // invariants of every peak of a composite spectrum (jonswapMultiSpec),
+    // the one above first; n is 0 for a single peak
+    const jonswapPeakParams &getPeakParams() const { return peaks; }
     
     vector<double> getamp(vector<double> w);
     
-    vector<double> calcPaddleAmps(double h);
+    void getamp(const double *w, double *amp, size_t n) const;
+    
+    // float version, e.g. for display
+    void getamp(const float *w, float *amp, size_t n) const;
+    
+    // alpha and wp from 10 m wind speed and fetch, as used by jonswapSpec(vel10, F)
+    static double calcAlpha(double vel10, double F, double g = 9.81);
+    static double calcWp(double vel10, double F, double g = 9.81);
+    
+    // H/S tables of the last 8 depths are kept until the bins change, so
+    // alternating between a few water levels only redoes the strokes; a
+    // sweep through many depths recomputes each one and holds 8 tables
+    const vector<double> &calcPaddleAmps(double h);
+    void setPaddleModel(const jonswapPaddleModel &model);
+    const jonswapPaddleModel &getPaddleModel() const { return transfer.getModel(); }
     
 	
 	virtual ~jonswapSpec ();
 
+protected:
+	// Superpose the peaks of m, m.c[0] .. being this spectrum's own peak
+	// as set by the constructor and setters. n < 2 makes it single again.
+	void setPeaks(const jonswapPeakParams &m);
+
 private:
 	double alpha, wp, wmax, gamma, s1, s2;
 	double vel10, F;
-    set<double> bounds;
-    vector<double> wc;
-    vector<double> amps;
-    vector<double> paddleAmps;
+    jonswapBins bins;
 	
 	double g;
+	jonswapKernelParams kp;
+	jonswapPeakParams peaks;
+	jonswapTransferCache transfer;
+
+	enum ampMethod { AMPS_NONE, AMPS_GAUSS, AMPS_ADAPTIVE, AMPS_CDF };
+	enum { DIRTY_AMPS = 1, DIRTY_PADDLE = 2 };
+	ampMethod method;
+	int nmems;
+	double tol;
+	double depth;          // 0 until a depth is given
+	unsigned dirty;
+
     double calcAlpha();
     double calcWp();
+    void initStages();
+    void setParams();
+    void scaleStages(double ratio);
+    void setBins();
+    void computeAmps(const jonswapCDF *cdf = NULL);
+    void computePaddleAmps();
+    const vector<double> &logBinAmps() const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,70 @@
+//
+//  jonswapSweep.cpp
+//
+
+#include "jonswapSweep.h"
+#include "jonswapSpec.h"
+#include "jonswapKernel.h"
+
+// states per task and frequencies per cache block
+static const size_t STATE_GRAIN = 64;
+static const size_t FREQ_BLOCK = 2048;
+
+template<class T>
+static void sweepRows(const jonswapKernelParams *p, size_t nrows, const T *w, size_t nfreq,
+		T *out) {
+	for (size_t f0 = 0; f0 < nfreq; f0 += FREQ_BLOCK) {
+		size_t nf = nfreq - f0 < FREQ_BLOCK ? nfreq - f0 : FREQ_BLOCK;
+		for (size_t i = 0; i < nrows; i++)
+			jonswapBatch(p[i], w + f0, out + i * nfreq + f0, nf);
+	}
+}
+
+template<class T>
+static void sweepStates(jonswapPool &pool, size_t nstates, const jonswapStates &states,
+		const T *w, size_t nfreq, T *out) {
+	pool.parallelFor(nstates, STATE_GRAIN, [&](size_t begin, size_t end, unsigned) {
+		jonswapKernelParams p[STATE_GRAIN];
+		for (size_t i = begin; i < end; i++) {
+			p[i - begin] = jonswapMakeKernelParams(states.alpha[i], states.wp[i],
+				states.gamma ? states.gamma[i] : 3.3,
+				states.s1 ? states.s1[i] : 0.07,
+				states.s2 ? states.s2[i] : 0.09, 9.81);
+		}
+		sweepRows(p, end - begin, w, nfreq, out + begin * nfreq);
+	});
+}
+
+template<class T>
+static void sweepWind(jonswapPool &pool, size_t nstates, const double *vel10, const double *F,
+		const T *w, size_t nfreq, T *out) {
+	pool.parallelFor(nstates, STATE_GRAIN, [&](size_t begin, size_t end, unsigned) {
+		jonswapKernelParams p[STATE_GRAIN];
+		for (size_t i = begin; i < end; i++) {
+			double alpha = jonswapSpec::calcAlpha(vel10[i], F[i]);
+			double wp = jonswapSpec::calcWp(vel10[i], F[i]);
+			p[i - begin] = jonswapMakeKernelParams(alpha, wp, 3.3, 0.7, 0.9, 9.81);
+		}
+		sweepRows(p, end - begin, w, nfreq, out + begin * nfreq);
+	});
+}
+
+void jonswapSweep(jonswapPool &pool, size_t nstates, const jonswapStates &states,
+		const double *w, size_t nfreq, double *out) {
+	sweepStates(pool, nstates, states, w, nfreq, out);
+}
+
+void jonswapSweep(jonswapPool &pool, size_t nstates, const jonswapStates &states,
+		const float *w, size_t nfreq, float *out) {
+	sweepStates(pool, nstates, states, w, nfreq, out);
+}
+
+void jonswapSweepWind(jonswapPool &pool, size_t nstates, const double *vel10, const double *F,
+		const double *w, size_t nfreq, double *out) {
+	sweepWind(pool, nstates, vel10, F, w, nfreq, out);
+}
+
+void jonswapSweepWind(jonswapPool &pool, size_t nstates, const double *vel10, const double *F,
+		const float *w, size_t nfreq, float *out) {
+	sweepWind(pool, nstates, vel10, F, w, nfreq, out);
+}
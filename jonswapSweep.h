@@ -0,0 +1,43 @@
+//
+//  jonswapSweep.h
+//
+//  Evaluate many sea states on one shared frequency grid in a single pass,
+//  filling a row-major [nstates x nfreq] matrix. Work is split over a
+//  jonswapPool by blocks of states, and each worker walks the grid in
+//  cache sized blocks so one block of w serves all of its states.
+//
+
+#ifndef JONSWAPSWEEP_H
+#define JONSWAPSWEEP_H
+
+#include <stddef.h>
+#include "jonswapPool.h"
+
+// Parameter columns, each nstates long. gamma, s1 and s2 may be null for
+// the jonswapSpec defaults 3.3, 0.07 and 0.09.
+struct jonswapStates {
+	const double *alpha;
+	const double *wp;
+	const double *gamma;
+	const double *s1;
+	const double *s2;
+};
+
+// out[i*nfreq + j] = S_i(w[j])
+void jonswapSweep(jonswapPool &pool, size_t nstates, const jonswapStates &states,
+		const double *w, size_t nfreq, double *out);
+
+// Same for sea states given by 10 m wind speed and fetch, with alpha and
+// wp from jonswapSpec::calcAlpha/calcWp and the jonswapSpec(vel10, F)
+// shape (gamma 3.3, s1 0.7, s2 0.9)
+void jonswapSweepWind(jonswapPool &pool, size_t nstates, const double *vel10, const double *F,
+		const double *w, size_t nfreq, double *out);
+
+// Float grid and matrix through the float kernels (accuracy in
+// jonswapKernel.h): half the memory traffic and twice the lanes
+void jonswapSweep(jonswapPool &pool, size_t nstates, const jonswapStates &states,
+		const float *w, size_t nfreq, float *out);
+void jonswapSweepWind(jonswapPool &pool, size_t nstates, const double *vel10, const double *F,
+		const float *w, size_t nfreq, float *out);
+
+#endif
@@ -0,0 +1,149 @@
+//
+//  jonswapSynth.cpp
+//
+
+#include <math.h>
+#include <string.h>
+#include <limits>
+#include "jonswapSynth.h"
+#include "jonswapRng.h"
+#include "jonswapProfile.h"
+
+// Independent partial sums per sample, one 32 byte vector of T (GCC/Clang
+// vector extension, split into two halves where the build has no AVX), so
+// each lane is the same arithmetic as a scalar loop over its components
+template<class T> struct synthVec;
+template<> struct synthVec<double> { typedef double type __attribute__((vector_size(32))); };
+template<> struct synthVec<float> { typedef float type __attribute__((vector_size(32))); };
+template<class T> struct synthLanes { enum { value = sizeof(typename synthVec<T>::type) / sizeof(T) }; };
+
+static const double TWO_PI = 2 * M_PI;
+
+template<class T>
+jonswapSynthT<T>::jonswapSynthT(double fs, size_t chunk)
+	: fs(fs), chunk(chunk ? chunk : 1), ncomp(0), pos(0), inChunk(0), buf(this->chunk) {
+}
+
+template<class T>
+void jonswapSynthT<T>::setComponents(const double *w, const double *a, size_t n, uint64_t seed) {
+	vector<double> phase(n);
+	jonswapRng rng(seed);
+	for (size_t i = 0; i < n; i++)
+		phase[i] = TWO_PI * rng.uniform();
+	setComponents(w, a, n ? &phase[0] : NULL, n);
+}
+
+template<class T>
+void jonswapSynthT<T>::setComponents(const double *w, const double *a, const double *phase, size_t n) {
+	const size_t LANES = synthLanes<T>::value;
+	ncomp = n;
+	size_t padded = (n + LANES - 1) / LANES * LANES;
+	amp.assign(padded, 0.0);
+	phi.assign(padded, 0.0);
+	adv.assign(padded, 0.0);
+	cr.assign(padded, 1.0);
+	ci.assign(padded, 0.0);
+	theta.resize(padded);
+	re.resize(padded);
+	im.resize(padded);
+
+	// amplitudes this small would turn into subnormal phasors in T, which
+	// are slow on most cpus, and add nothing a sum of T can hold
+	const double tiny = sqrt(std::numeric_limits<T>::min());
+	for (size_t i = 0; i < n; i++) {
+		double step = w[i] / fs;
+		amp[i] = fabs(a[i]) < tiny ? 0 : a[i];
+		phi[i] = fmod(phase[i], TWO_PI);
+		if (phi[i] < 0)
+			phi[i] += TWO_PI;
+		adv[i] = fmod(step * chunk, TWO_PI);
+		cr[i] = cos(step);
+		ci[i] = sin(step);
+	}
+	reset();
+}
+
+template<class T>
+void jonswapSynthT<T>::setComponents(const jonswapBins &bins, uint64_t seed) {
+	size_t n = bins.paddleAmps.size();
+	setComponents(n ? &bins.wc[0] : NULL, n ? &bins.paddleAmps[0] : NULL, n, seed);
+}
+
+template<class T>
+void jonswapSynthT<T>::reset() {
+	theta = phi;
+	pos = 0;
+	resync();
+}
+
+template<class T>
+void jonswapSynthT<T>::resync() {
+	for (size_t i = 0; i < theta.size(); i++) {
+		re[i] = amp[i] * cos(theta[i]);
+		im[i] = amp[i] * sin(theta[i]);
+	}
+	inChunk = 0;
+}
+
+template<class T>
+void jonswapSynthT<T>::render(T *out, size_t n) {
+	typedef typename synthVec<T>::type vec;
+	const size_t LANES = synthLanes<T>::value;
+	size_t m = re.size();
+	T *pr = m ? &re[0] : NULL, *pi = m ? &im[0] : NULL;
+	const T *pc = m ? &cr[0] : NULL, *ps = m ? &ci[0] : NULL;
+
+	for (size_t j = 0; j < n; j++) {
+		vec acc = {};
+		for (size_t i = 0; i < m; i += LANES) {
+			vec r, s, c, d;
+			memcpy(&r, pr + i, sizeof(vec));
+			memcpy(&s, pi + i, sizeof(vec));
+			memcpy(&c, pc + i, sizeof(vec));
+			memcpy(&d, ps + i, sizeof(vec));
+			acc += r;
+			vec nr = r * c - s * d, ni = r * d + s * c;
+			memcpy(pr + i, &nr, sizeof(vec));
+			memcpy(pi + i, &ni, sizeof(vec));
+		}
+		T sum = 0;
+		for (size_t l = 0; l < LANES; l++)
+			sum += acc[l];
+		out[j] = sum;
+	}
+}
+
+template<class T>
+void jonswapSynthT<T>::generate(T *out, size_t n) {
+	JONSWAP_PROFILE_SCOPE(JONSWAP_STAGE_SYNTH);
+	JONSWAP_PROFILE_COUNT(JONSWAP_COUNT_SAMPLES, n);
+	while (n > 0) {
+		if (inChunk == chunk) {
+			for (size_t i = 0; i < theta.size(); i++) {
+				theta[i] += adv[i];
+				if (theta[i] >= TWO_PI)
+					theta[i] -= TWO_PI;
+			}
+			resync();
+		}
+		size_t m = chunk - inChunk < n ? chunk - inChunk : n;
+		render(out, m);
+		inChunk += m;
+		pos += m;
+		out += m;
+		n -= m;
+	}
+}
+
+template<class T>
+void jonswapSynthT<T>::run(uint64_t nsamples, const sink &f) {
+	while (nsamples > 0) {
+		size_t m = nsamples < chunk ? (size_t) nsamples : chunk;
+		generate(&buf[0], m);
+		f(&buf[0], m);
+		nsamples -= m;
+	}
+}
+
+template class jonswapSynthT<double>;
+template class jonswapSynthT<float>;
@@ -0,0 +1,90 @@
+//
+//  jonswapSynth.h
+//
+//  Streaming synthesis of x(t) = sum_i A_i cos(w_i t + phi_i) from binned
+//  components, e.g. the paddle stroke signal from wc and paddleAmps.
+//
+//  Each component is a phasor A exp(i theta) rotated by exp(i w/fs) every
+//  sample, so a sample costs a complex multiply per component instead of a
+//  cos. The phasors are stored as separate re/im arrays and rebuilt from
+//  their exact phases at the start of every chunk, which keeps the drift of
+//  the recursion bounded by one chunk however long the run is. Memory does
+//  not grow with the length of the run.
+//
+//  Phases are drawn from jonswapRng, so a seed reproduces the signal.
+//
+//  The phasors and the samples are of type T, double (jonswapSynth) or
+//  float (jonswapSynthF, twice the lanes). Phases stay double, so a float
+//  synth only drifts within a chunk: with 1024 sample chunks its samples
+//  stay within 2e-5 times the signal's peak of the double synth's (synthf
+//  in jonswap_validate).
+//
+
+#ifndef JONSWAPSYNTH_H
+#define JONSWAPSYNTH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+#include <vector>
+#include "jonswapBins.h"
+
+using std::vector;
+
+template<class T>
+class jonswapSynthT
+{
+public:
+	// receives each chunk of samples; only valid during the call
+	typedef std::function<void(const T *x, size_t n)> sink;
+
+	// fs in samples per second; chunk = samples between phasor resyncs
+	explicit jonswapSynthT(double fs, size_t chunk = 1024);
+
+	// n components with angular frequency w and amplitude amp, uniform
+	// random phases from seed; restarts at t = 0
+	void setComponents(const double *w, const double *amp, size_t n, uint64_t seed);
+
+	// same with the phases given
+	void setComponents(const double *w, const double *amp, const double *phase, size_t n);
+
+	// wc and paddleAmps of the bins
+	void setComponents(const jonswapBins &bins, uint64_t seed);
+
+	// back to t = 0 with the same phases
+	void reset();
+
+	// next n samples into out
+	void generate(T *out, size_t n);
+
+	// next nsamples samples to f, in chunks of at most chunkSize()
+	void run(uint64_t nsamples, const sink &f);
+
+	uint64_t position() const { return pos; }
+	double rate() const { return fs; }
+	size_t chunkSize() const { return chunk; }
+	size_t components() const { return ncomp; }
+	const vector<double> &phases() const { return phi; }
+
+private:
+	double fs;
+	size_t chunk, ncomp;
+	uint64_t pos;
+	size_t inChunk;              // samples done in the current chunk
+
+	// per component, padded to a multiple of LANES with zero amplitude
+	vector<double> amp, phi;
+	vector<double> theta;        // phase at the start of the current chunk
+	vector<double> adv;          // phase advance over one chunk, mod 2 pi
+	vector<T> re, im;            // current phasors
+	vector<T> cr, ci;            // rotation per sample
+	vector<T> buf;               // one chunk for run()
+
+	void resync();
+	void render(T *out, size_t n);
+};
+
+typedef jonswapSynthT<double> jonswapSynth;
+typedef jonswapSynthT<float> jonswapSynthF;
+
+#endif
@@ -10,7 +10,10 @@
 #include <fstream>
 #include <stdio.h>
 #include <vector>
+#include <string.h>
 #include "jonswapSpec.h"
+#include "jonswapIO.h"
+#include "jonswapProfile.h"
 
 using std::ostream;
 using std::ofstream;
@@ -23,19 +26,25 @@ int main(int argc, char *argv[]) {
     vector<double> dist;
     vector<double> wc;
     vector<double> amps;
-    set<double> bounds;
+    vector<double> bounds;
     vector<double>::iterator wc_it;
     vector<double>::iterator amps_it;
-    set<double>::iterator bounds_it;
-    vector<double>::iterator it;
-    vector<double>::iterator dist_it;
     vector<double> paddleAmps;
     double max_freq;
     int count = 0;
 	int nbins = 10;
+	bool text = false;
+	bool profile = false;
 //  nbins can be changed during execution: for example, 'jonswap 20'  
-	if(argc > 1) {
-		nbins = atoi(argv[1]);
+//  'jonswap -t' also writes the old jonswap_*.txt dumps next to jonswap.bin
+//  'jonswap -p' prints the stage profile (needs a make PROFILE=1 build)
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-t"))
+			text = true;
+		else if (!strcmp(argv[i], "-p"))
+			profile = true;
+		else
+			nbins = atoi(argv[i]);
 	}
 	
 // initialize spectrum with alpha, peak radial frequency, and max radial frequency
@@ -46,7 +55,7 @@ int main(int argc, char *argv[]) {
     
     jonswap.bin(nbins);          // sets number of bins, finds bounds and center values of frequency
     cout<<"bins ok" <<endl;
-    bounds = jonswap.getBins();  // returns bin bounds
+    bounds = jonswap.getBins();  // returns bin bounds, 0 and wmax included
     wc = jonswap.getWCs(); //wc  bin center angular frequencies (method defined in .h file)
     cout <<"size of wc: " <<wc.size()<<endl;
     amps = jonswap.calcBinAmps(20);  // calculate the bin average amplitude
@@ -63,55 +72,52 @@ int main(int argc, char *argv[]) {
     amps_it = amps.begin();
     wc_it = wc.begin();
    
-    ofstream data0;
-    data0.open("jonswap_sample.txt",std::ofstream::out|ofstream::trunc);
-    
-    for (bounds_it = bounds.begin(); bounds_it != bounds.end(); ++bounds_it) {
+    for (size_t i = 0; i + 1 < bounds.size(); i++) {
 		cout << count << "\t";
-        if (bounds_it == bounds.begin()) {
-            cout << "0 - " << *bounds_it << "\t\t: " << *wc_it << "\t" << *amps_it << endl;
-            data0 << *wc_it <<"\t"<<*amps_it <<endl;
-        } else {
-            cout << *prev(bounds_it) << " - " << *bounds_it << "\t: " << *wc_it << "\t" << *amps_it << endl;
-            data0 << *wc_it <<"\t"<<*amps_it <<endl;
-        }
+        cout << bounds[i] << " - " << bounds[i + 1] << "\t: " << *wc_it << "\t" << *amps_it << endl;
         
         wc_it++;
         amps_it++;
 		count++;
     }
     
-    cout << count << "\t";
-    cout << *prev(bounds.end()) << " - " << jonswap.getWmax() << "\t\t: " << *wc_it << "\t" << *amps_it << endl;
-    data0 << *wc_it <<"\t"<<*amps_it <<endl;
-    data0.close();
-    
     // Calculate the actual spectrum for comparison
     double di=max_freq/200.;
     for (double i = 0.0; i < max_freq; i += di )
         w.push_back(i);
     
-    dist = jonswap.getamp(w);
+    dist = jonswap.getamp(w);   // skips w[0]
+    
+    // everything in one binary file, see jonswapIO.h
+    vector<double> wS(w.begin() + 1, w.end());
+    if (!jonswapWriteFile("jonswap.bin", jonswap, wS, dist, depth))
+        cout << "can't write jonswap.bin" << endl;
+    if (profile) {
+        if (!jonswapProfileEnabled())
+            cout << "profile not compiled in, rebuild with make PROFILE=1" << endl;
+        jonswapProfileSnapshot snap = jonswapProfileGet();
+        snap.print(cout);
+        cout << snap.json() << endl;
+    }
+    if (!text)
+        return 0;
     
-    dist_it = dist.begin();
+    ofstream data0;
+    data0.open("jonswap_sample.txt",std::ofstream::out|ofstream::trunc);
+    for (size_t i = 0; i < wc.size(); i++)
+        data0 << wc[i] <<"\t"<< amps[i] <<"\n";
+    data0.close();
     
+    // the old dumps pair w[i] with dist[i], i.e. with S(w[i+1])
     ofstream data;
     data.open("jonswap_spec.txt",std::ofstream::out|std::ofstream::trunc);
-    
-//    data << "w\t\tamp"<< endl;
-    for (it = w.begin(); it != w.end(); ++it) {
-        data << *it << "\t" << *dist_it <<endl;
-        dist_it++;
-    }
+    for (size_t i = 0; i < dist.size(); i++)
+        data << w[i] << "\t" << dist[i] << "\n";
     data.close();
     
     ofstream data2;
     data2.open("jonswap_amps.txt",std::ofstream::out|std::ofstream::trunc);
-    amps_it = paddleAmps.begin();
-//    data << "w\t\tamp"<< endl;
-    for (it = wc.begin(); it != wc.end(); ++it) {
-        data2 << *it << "\t" << *amps_it <<endl;
-        amps_it++;
-    }
+    for (size_t i = 0; i < wc.size(); i++)
+        data2 << wc[i] << "\t" << paddleAmps[i] << "\n";
     data2.close();
-}
\ No newline at end of file
+}
@@ -0,0 +1,531 @@
+//
+//  jonswapValidate.cpp
+//
+//  Accuracy of the fast paths against a long double reference of the
+//  original pow() formulation of the spectrum. For every sea state of the
+//  corpus it reports max and RMS relative error of the point evaluations
+//  (getamp, jonswapEval, jonswapFixed, every batch kernel this cpu runs)
+//  and of the bin energies (Gauss-Legendre, Gauss-Kronrod, CDF table), the
+//  error of the total energy m0, the worst relative error of the moments
+//  m0, m1, m2, m4 of jonswapSpectrumMoments, the same for the float paths
+//  (kernels, mixed precision quadrature and moments, synthesis), and the
+//  throughput of each path. Exits with 1 if any path misses its tolerance. Use makefile:
+//  make validate
+//
+//  Point errors are relative to the reference value. The exponent
+//  1.2 (wp/w)^4 reaches several hundred in the low frequency tail, so even
+//  a correctly rounded double evaluation is only good to some 1e-13 there.
+//  Bin errors are relative to the reference bin energy for bins holding
+//  at least 1e-6 of m0; the rest are below anything a paddle reproduces.
+//  The quadrature tolerances are set a little above the worst state at the
+//  default 200 bins; coarser bins (-b) need looser -t and -m.
+//  fixed is jonswapWind on the wind states and jonswapDefault on states
+//  with the defaults of jonswapSpec(alpha, wp, wmax), and fails if the
+//  shape's constants are not the spec's; fixedPM is the Pierson-Moskowitz
+//  shape on every state against the reference with gamma = 1.
+//  Float points count where S is at least 1e-6 of its peak (batchf) or
+//  1e-30 of it (tailf). synthf is the largest deviation of jonswapSynthF
+//  from jonswapSynth over the peak of the signal. paddle_<model> is the
+//  stroke of jonswapPaddleAmps against the closed form flap and piston H/S
+//  of the original calcPaddleAmps, at two depths, dividing by H/S once.
+//  transfer_cache ramps a capped jonswapTransferCache through more depths
+//  than it holds; any table that differs from a fresh solve, a cache over
+//  its cap, or a recently used depth solved again fails it.
+//  live_phases is the largest correlation of the phases of a
+//  jonswapLive configuration with the jitter of the edges of their bins.
+//
+//  usage: jonswap_validate [-t path=tol ...] [-m path=tol ...] [-n npoints] [-b nbins]
+//         -t max relative error, -m relative m0 error, for the paths
+//         getamp eval fixed fixedPM batch batchf tailf gauss4 gauss8
+//         gauss8_mixed gk15 cdf moments moments_mixed synthf paddle
+//         transfer_cache live_phases
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include "jonswapSpec.h"
+#include "jonswapEval.h"
+#include "jonswapFixed.h"
+#include "jonswapQuad.h"
+#include "jonswapCDF.h"
+#include "jonswapMoments.h"
+#include "jonswapSynth.h"
+#include "jonswapPipeline.h"
+#include "jonswapLive.h"
+
+using std::vector;
+
+struct seaState {
+	const char *name;
+	double alpha, wp, wmax, gamma, s1, s2;
+	double vel10, F;   // if vel10 > 0 the state comes from jonswapSpec(vel10, F)
+};
+
+static const seaState CORPUS[] = {
+	{ "jonswapTest",    0.05,   3.5,    6.0, 3.3, 0.07, 0.09,  0,   0 },
+	{ "jonswapTestRAD", 0.05,   0.5711, 3.0, 3.3, 0.07, 0.09,  0,   0 },
+	{ "wind15_2e4",     0,      0,      0,   0,   0,    0,    15, 2e4 },
+	{ "wind8_1e5",      0,      0,      0,   0,   0,    0,     8, 1e5 },
+	{ "wind25_5e3",     0,      0,      0,   0,   0,    0,    25, 5e3 },
+	{ "PM",             0.0081, 0.8,    4.0, 1.0, 0.07, 0.09,  0,   0 },
+	{ "peaky",          0.02,   1.2,    5.0, 7.0, 0.07, 0.09,  0,   0 },
+	{ "broad",          0.01,   2.0,    8.0, 2.0, 0.2,  0.3,   0,   0 },
+};
+
+struct tolerance {
+	const char *path;   // batch covers every batch_<kernel>, the first prefix wins
+	double maxRel, m0;
+};
+
+static tolerance TOLS[] = {
+	{ "getamp", 1e-12, 0 },
+	{ "eval",   1e-12, 0 },
+	{ "fixed",  1e-12, 0 },    // and fixedPM
+	{ "batchf", 1e-5,  0 },    // before batch, which is its prefix
+	{ "tailf",  5e-5,  0 },
+	{ "batch",  1e-12, 0 },
+	{ "gauss4", 3e-5,  3e-6 },   // peaky measures 1.7e-5 and 2.1e-6 at 200 bins
+	{ "gauss8_mixed", 1e-5, 1e-6 },
+	{ "gauss8", 5e-6,  5e-7 },   // peaky measures 3.1e-6 and 3.7e-7
+	{ "gk15",   1e-9,  1e-12 },
+	{ "cdf",    1e-5,  1e-9 },
+	{ "moments_mixed", 3e-7, 0 },
+	{ "moments", 1e-12, 0 },
+	{ "synthf", 3e-5, 0 },
+	{ "paddle", 1e-14, 0 },
+	{ "transfer_cache", 0, 0 },  // cached tables are the very same numbers
+	{ "live_phases", 0.08, 0 },  // 5 sigma of the correlation of 4000 pairs
+};
+
+static tolerance *tolFor(const std::string &path) {
+	for (size_t i = 0; i < sizeof(TOLS)/sizeof(TOLS[0]); i++)
+		if (!path.compare(0, strlen(TOLS[i].path), TOLS[i].path))
+			return &TOLS[i];
+	return NULL;
+}
+
+// baseline jonswapSpec::getamp, in long double
+static long double refAmp(const seaState &s, long double w) {
+	if (w <= 0)
+		return 0;
+	long double sig = w > s.wp ? s.s2 : s.s1;
+	long double dw = (w - s.wp) / (sig * s.wp);
+	long double r = expl(-dw * dw / 2);
+	long double g = 9.81;
+	return s.alpha * g * g * powl(w, -5) * expl(-1.2L * powl(s.wp / w, 4)) * powl((long double) s.gamma, r);
+}
+
+// paddle stroke of one bin with the closed forms of the original
+// calcPaddleAmps: the explicit kh, then the surface amplitude over H/S
+static long double refStroke(long double area, long double wc, long double h, jonswapPaddleType type) {
+	long double k0h = wc * wc / 9.81L * h;
+	long double kh = k0h * powl(1 - expl(-powl(k0h, 1.25L)), -0.4L);
+	long double HoS = type == JONSWAP_PADDLE_PISTON
+		? 2 * (coshl(2 * kh) - 1) / (sinhl(2 * kh) + 2 * kh)
+		: 4 * (sinhl(kh) / kh) * (kh * sinhl(kh) - coshl(kh) + 1) / (sinhl(2 * kh) + 2 * kh);
+	return sqrtl(2 * area) / HoS;
+}
+
+// Pearson correlation of x and y
+static double correlation(const vector<double> &x, const vector<double> &y) {
+	size_t n = x.size();
+	double mx = 0, my = 0, sxy = 0, sxx = 0, syy = 0;
+	for (size_t i = 0; i < n; i++) {
+		mx += x[i] / n;
+		my += y[i] / n;
+	}
+	for (size_t i = 0; i < n; i++) {
+		sxy += (x[i] - mx) * (y[i] - my);
+		sxx += (x[i] - mx) * (x[i] - mx);
+		syy += (y[i] - my) * (y[i] - my);
+	}
+	return sxx > 0 && syy > 0 ? sxy / sqrt(sxx * syy) : 0;
+}
+
+// composite Simpson of w^k S, fine enough that its own error is below
+// double eps
+static long double refArea(const seaState &s, double a, double b, int k = 0) {
+	const int panels = 2048;
+	long double h = ((long double) b - a) / panels;
+	long double sum = 0;
+	for (int i = 0; i <= panels; i++) {
+		long double w = a + i * h;
+		sum += (i == 0 || i == panels ? 1 : i % 2 ? 4 : 2) * refAmp(s, w) * powl(w, k);
+	}
+	return sum * h / 3;
+}
+
+typedef std::chrono::steady_clock validateClock;
+
+template<class F> static double rateOf(F f, size_t items) {
+	int reps = 0;
+	validateClock::time_point start = validateClock::now();
+	double t;
+	do {
+		f();
+		reps++;
+		t = std::chrono::duration<double>(validateClock::now() - start).count();
+	} while (t < 0.05);
+	return items * reps / t;
+}
+
+template<class Shape> static bool hasShape(const jonswapSpec &spec) {
+	return spec.getGamma() == Shape::gamma && spec.getS1() == Shape::s1 && spec.getS2() == Shape::s2;
+}
+
+struct errors {
+
+	double maxRel, sumSq;
+	size_t n;
+
+	errors() : maxRel(0), sumSq(0), n(0) {}
+	// values below floor are skipped
+	void add(double x, long double ref, long double floor = 1e-290L) {
+		if (ref < floor)
+			return;
+		double rel = (double) fabsl((x - ref) / ref);
+		maxRel = fmax(maxRel, rel);
+		sumSq += rel * rel;
+		n++;
+	}
+	double rms() const { return n ? sqrt(sumSq / n) : 0; }
+};
+
+static int failures = 0;
+
+static void report(const char *state, const char *path, const errors &e, double rate,
+		const char *unit, double m0Err = -1) {
+	const tolerance *t = tolFor(path);
+	bool ok = !t || (e.maxRel <= t->maxRel && (m0Err < 0 || m0Err <= t->m0));
+	if (!ok)
+		failures++;
+	printf("%-15s %-14s max %9.3g  rms %9.3g", state, path, e.maxRel, e.rms());
+	if (m0Err >= 0)
+		printf("  m0 %9.3g", m0Err);
+	else
+		printf("  %12s", "");
+	printf("  %10.4g %s/s  %s\n", rate, unit, ok ? "ok" : "FAIL");
+}
+
+int main(int argc, char *argv[]) {
+	size_t npoints = 100000;
+	size_t nbins = 200;
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+			npoints = atol(argv[++i]);
+		} else if (!strcmp(argv[i], "-b") && i + 1 < argc) {
+			nbins = atol(argv[++i]);
+		} else if ((!strcmp(argv[i], "-t") || !strcmp(argv[i], "-m")) && i + 1 < argc) {
+			bool m0 = argv[i][1] == 'm';
+			char *eq = strchr(argv[++i], '=');
+			tolerance *t = eq ? tolFor(std::string(argv[i], eq)) : NULL;
+			if (!t) {
+				fprintf(stderr, "jonswap_validate: bad tolerance %s\n", argv[i]);
+				return 2;
+			}
+			(m0 ? t->m0 : t->maxRel) = atof(eq + 1);
+		} else {
+			fprintf(stderr, "usage: jonswap_validate [-t path=tol ...] [-m path=tol ...] [-n npoints] [-b nbins]\n");
+			return 2;
+		}
+	}
+
+	const jonswapKernelType kernels[] = {
+		JONSWAP_KERNEL_SCALAR, JONSWAP_KERNEL_AVX2, JONSWAP_KERNEL_AVX512, JONSWAP_KERNEL_NEON
+	};
+
+	for (size_t c = 0; c < sizeof(CORPUS)/sizeof(CORPUS[0]); c++) {
+		seaState s = CORPUS[c];
+		jonswapSpec spec = s.vel10 > 0 ? jonswapSpec(s.vel10, s.F)
+			: jonswapSpec(s.alpha, s.wp, s.wmax, s.gamma, s.s1, s.s2);
+		if (s.vel10 > 0) {
+			s.alpha = jonswapSpec::calcAlpha(s.vel10, s.F);
+			s.wp = jonswapSpec::calcWp(s.vel10, s.F);
+			s.wmax = spec.getWmax();
+			s.gamma = 3.3;
+			s.s1 = 0.7;
+			s.s2 = 0.9;
+		}
+
+		// points
+		vector<double> w(npoints), out(npoints);
+		vector<long double> ref(npoints);
+		for (size_t i = 0; i < npoints; i++) {
+			w[i] = (i + 1) * s.wmax / npoints;
+			ref[i] = refAmp(s, w[i]);
+		}
+
+		errors eg;
+		double rg = rateOf([&]() {
+			for (size_t i = 0; i < npoints; i++)
+				out[i] = spec.getamp(w[i]);
+		}, npoints);
+		for (size_t i = 0; i < npoints; i++)
+			eg.add(out[i], ref[i]);
+		report(s.name, "getamp", eg, rg, "points");
+
+		const jonswapEval eval(spec);
+		errors ee;
+		double re = rateOf([&]() {
+			for (size_t i = 0; i < npoints; i++)
+				out[i] = eval(w[i]);
+		}, npoints);
+		for (size_t i = 0; i < npoints; i++)
+			ee.add(out[i], ref[i]);
+		report(s.name, "eval", ee, re, "points");
+
+		// compile time shapes: the wind one for wind states, the default one
+		// for states with jonswapSpec(alpha, wp, wmax)'s defaults; either
+		// fails if its constants are not the spec's. PM on every state
+		// against the reference with gamma = 1.
+		jonswapSpec defaults(s.alpha, s.wp, s.wmax);
+		bool wind = s.vel10 > 0;
+		if (wind || (s.gamma == defaults.getGamma() && s.s1 == defaults.getS1() && s.s2 == defaults.getS2())) {
+			const jonswapDefault fd(s.alpha, s.wp);
+			const jonswapWind fw(s.alpha, s.wp);
+			errors ef;
+			double rf = rateOf([&]() {
+				for (size_t i = 0; i < npoints; i++)
+					out[i] = wind ? fw(w[i]) : fd(w[i]);
+			}, npoints);
+			for (size_t i = 0; i < npoints; i++)
+				ef.add(out[i], ref[i]);
+			if (wind ? !hasShape<jonswapWindShape>(spec) : !hasShape<jonswapDefaultShape>(defaults))
+				ef.add(2, 1);
+			report(s.name, "fixed", ef, rf, "points");
+		}
+		seaState pms = s;
+		pms.gamma = 1;
+		const jonswapPM fpm(s.alpha, s.wp);
+		errors ep;
+		double rp = rateOf([&]() {
+			for (size_t i = 0; i < npoints; i++)
+				out[i] = fpm(w[i]);
+		}, npoints);
+		for (size_t i = 0; i < npoints; i++)
+			ep.add(out[i], refAmp(pms, w[i]));
+		report(s.name, "fixedPM", ep, rp, "points");
+
+		for (size_t k = 0; k < sizeof(kernels)/sizeof(kernels[0]); k++) {
+			if (!jonswapSetKernel(kernels[k]))
+				continue;
+			errors eb;
+			double rb = rateOf([&]() { eval(&w[0], &out[0], npoints); }, npoints);
+			for (size_t i = 0; i < npoints; i++)
+				eb.add(out[i], ref[i]);
+			std::string path = std::string("batch_") + jonswapKernelName(kernels[k]);
+			report(s.name, path.c_str(), eb, rb, "points");
+		}
+		jonswapSetKernel(JONSWAP_KERNEL_AUTO);
+
+		// float kernels
+		long double peak = 0;
+		for (size_t i = 0; i < npoints; i++)
+			peak = fmaxl(peak, ref[i]);
+		vector<float> wf(w.begin(), w.end()), outf(npoints);
+		for (size_t k = 0; k < sizeof(kernels)/sizeof(kernels[0]); k++) {
+			if (!jonswapSetKernel(kernels[k]))
+				continue;
+			errors eb, et;
+			double rb = rateOf([&]() { eval(&wf[0], &outf[0], npoints); }, npoints);
+			for (size_t i = 0; i < npoints; i++) {
+				// against the reference at the float frequency
+				long double r = refAmp(s, wf[i]);
+				eb.add(outf[i], r, 1e-6L * peak);
+				et.add(outf[i], r, 1e-30L * peak);
+			}
+			std::string path = std::string("batchf_") + jonswapKernelName(kernels[k]);
+			report(s.name, path.c_str(), eb, rb, "points");
+			path = std::string("tailf_") + jonswapKernelName(kernels[k]);
+			report(s.name, path.c_str(), et, rb, "points");
+		}
+		jonswapSetKernel(JONSWAP_KERNEL_AUTO);
+
+		// bins
+		spec.bin((int) nbins, 1);
+		const vector<double> &edges = spec.getBins();
+		size_t nb = edges.size() - 1;
+		vector<long double> refBins(nb);
+		long double refM0 = 0;
+		for (size_t i = 0; i < nb; i++) {
+			refBins[i] = refArea(s, edges[i], edges[i + 1]);
+			refM0 += refBins[i];
+		}
+
+		vector<double> area(nb);
+		jonswapQuad quad;
+		jonswapCDF cdf(eval, s.wmax);
+		const int orders[] = { 4, 8 };
+		for (int p = 0; p < 5; p++) {
+			const char *path;
+			char name[16];
+			double rate;
+			if (p < 2) {
+				quad.setOrder(orders[p]);
+				snprintf(name, sizeof(name), "gauss%d", orders[p]);
+				path = name;
+				rate = rateOf([&]() { quad.integrate(eval, &edges[0], nb, &area[0]); }, nb);
+			} else if (p == 4) {
+			path = "gauss8_mixed";
+			quad.setOrder(8);
+			quad.setPrecision(JONSWAP_PRECISION_MIXED);
+			rate = rateOf([&]() { quad.integrate(eval, &edges[0], nb, &area[0]); }, nb);
+			quad.setPrecision(JONSWAP_PRECISION_DOUBLE);
+		} else if (p == 2) {
+				path = "gk15";
+				rate = rateOf([&]() { quad.integrateAdaptive(eval, &edges[0], nb, &area[0], 1e-10); }, nb);
+			} else {
+				path = "cdf";
+				rate = rateOf([&]() { cdf.binEnergies(&edges[0], nb, &area[0]); }, nb);
+			}
+
+			errors ea;
+			long double m0 = 0;
+			for (size_t i = 0; i < nb; i++) {
+				ea.add(area[i], refBins[i], 1e-6L * refM0);
+				m0 += area[i];
+			}
+			report(s.name, path, ea, rate, "bins", (double) fabsl((m0 - refM0) / refM0));
+		}
+
+		// moments over [0, wmax], reference split at wp like the fast path
+		const int ks[] = { 0, 1, 2, 4 };
+		long double refM[5] = { 0, 0, 0, 0, 0 };
+		for (int k : ks)
+			for (int half = 0; half < 2; half++)
+				for (int p = 0; p < 32; p++) {
+					double a = half ? s.wp : 0, b = half ? s.wmax : s.wp;
+					refM[k] += refArea(s, a + p * (b - a) / 32, a + (p + 1) * (b - a) / 32, k);
+				}
+		jonswapStats st;
+		double rm = rateOf([&]() { st = jonswapSpectrumMoments(eval, s.wmax); }, 1);
+		const double m[5] = { st.m0, st.m1, st.m2, st.m3, st.m4 };
+		errors em;
+		for (int k : ks)
+			em.add(m[k], refM[k]);
+		report(s.name, "moments", em, rm, "spectra");
+
+		rm = rateOf([&]() {
+			st = jonswapSpectrumMoments(eval, s.wmax, 256, 8, JONSWAP_PRECISION_MIXED);
+		}, 1);
+		const double mx[5] = { st.m0, st.m1, st.m2, st.m3, st.m4 };
+		errors ex;
+		for (int k : ks)
+			ex.add(mx[k], refM[k]);
+		report(s.name, "moments_mixed", ex, rm, "spectra");
+
+		// float synthesis of the bins against the double one, relative to
+		// the peak of the signal
+		spec.calcBinAmps(8);
+		const jonswapBins &bd = spec.getBinData();
+		vector<double> amp(nb);
+		for (size_t i = 0; i < nb; i++)
+			amp[i] = sqrt(2 * bd.amps[i] * bd.width[i]);
+		const size_t nsamples = 20000;
+		const double fs = 20 * s.wmax / (2 * M_PI);
+		jonswapSynth sd(fs);
+		jonswapSynthF sf(fs);
+		sd.setComponents(&bd.wc[0], &amp[0], nb, 1);
+		sf.setComponents(&bd.wc[0], &amp[0], nb, 1);
+		vector<double> xd(nsamples);
+		vector<float> xf(nsamples);
+		sd.generate(&xd[0], nsamples);
+		double rs = rateOf([&]() { sf.reset(); sf.generate(&xf[0], nsamples); }, nsamples);
+		double xpeak = 0, dev = 0;
+		for (size_t j = 0; j < nsamples; j++) {
+			xpeak = fmax(xpeak, fabs(xd[j]));
+			dev = fmax(dev, fabs(xf[j] - xd[j]));
+		}
+		errors es;
+		es.add(xpeak + dev, xpeak);
+		report(s.name, "synthf", es, rs, "samples");
+
+		// paddle strokes of those bins, H/S divided out once
+		const jonswapPaddleType paddles[] = { JONSWAP_PADDLE_FLAP, JONSWAP_PADDLE_PISTON };
+		const double depths[] = { 0.4, 2.0 };
+		for (jonswapPaddleType type : paddles) {
+			jonswapPaddleModel model;
+			model.type = type;
+			jonswapBins pb = bd;
+			errors ep;
+			double rp = 0;
+			for (double h : depths) {
+				rp += rateOf([&]() { jonswapPaddleAmps(pb, h, model); }, nb) / 2;
+				for (size_t i = 0; i < nb; i++)
+					ep.add(pb.paddleAmps[i], refStroke((long double) bd.amps[i] * bd.width[i],
+						bd.wc[i], h, type));
+			}
+			std::string path = std::string("paddle_") + jonswapPaddleName(type);
+			report(s.name, path.c_str(), ep, rp, "bins");
+		}
+
+		// a tide ramp through more depths than the H/S cache holds: every
+		// table as a fresh solve, the cap kept, the last depths reused
+		{
+			const size_t cap = 4, ndepths = 20;
+			jonswapTransferCache tc(jonswapPaddleModel(), 0, cap);
+			tc.setFrequencies(bd.wc);
+			vector<double> kh(nb), fresh(nb);
+			errors ec;
+			double rc = rateOf([&]() {
+				for (size_t d = 0; d < ndepths; d++)
+					tc.HoS(0.3 + 0.1 * d);
+			}, ndepths);
+			tc.clear();
+			uint64_t solved = 0;
+			for (size_t pass = 0; pass < 2; pass++) {
+				// the second pass only revisits the last cap depths
+				if (pass)
+					solved = tc.solves();
+				for (size_t d = pass ? ndepths - cap : 0; d < ndepths; d++) {
+					double h = 0.3 + 0.1 * d;
+					const vector<double> &t = tc.HoS(h);
+					jonswapDispersion(&bd.wc[0], nb, h, &kh[0]);
+					jonswapTransfer(jonswapPaddleModel(), &kh[0], nb, h, &fresh[0]);
+					for (size_t i = 0; i < nb; i++)
+						ec.add(1 + fabs(t[i] - fresh[i]) / fabs(fresh[i]), 1);
+					if (tc.tables() > cap)
+						ec.add(2, 1);
+				}
+			}
+			if (tc.solves() != solved)
+				ec.add(2, 1);  // a recently used depth was solved again
+			report(s.name, "transfer_cache", ec, rc, "depths");
+		}
+
+		// phases of a live configuration against the jitter of the edges
+		// either side of their bin, both fractions of [0, 1)
+		{
+			const int nlive = 4000;
+			jonswapLive live(fs);
+			std::unique_ptr<jonswapLiveConfig> c;
+			double rl = rateOf([&]() { c = live.prepare(spec, nlive, 8, 1.0, 42); }, nlive);
+			const vector<double> &le = c->bins.edges;
+			const vector<double> &phi = c->synth.phases();
+			double width = s.wmax / nlive;
+			vector<double> u(nlive - 1), below(nlive - 1), above(nlive - 1);
+			for (int i = 1; i < nlive; i++)
+				u[i - 1] = (le[i] - i * width + width / 2) / (0.4 * width);
+			for (int i = 1; i < nlive; i++) {
+				below[i - 1] = phi[i] / (2 * M_PI);     // bin i starts at edge i
+				above[i - 1] = phi[i - 1] / (2 * M_PI); // bin i-1 ends there
+			}
+			errors el;
+			el.add(1 + fmax(fabs(correlation(u, below)), fabs(correlation(u, above))), 1);
+			report(s.name, "live_phases", el, rl, "bins");
+		}
+	}
+
+	if (failures) {
+		printf("%d paths out of tolerance\n", failures);
+		return 1;
+	}
+	printf("all paths within tolerance\n");
+	return 0;
+}
@@ -0,0 +1,34 @@
+"""Load a binary file written by jonswapWriteFile (see jonswapIO.h).
+
+The arrays are numpy views into a read-only memory map of the file, so
+loading costs nothing until they are used:
+
+    import jonswap_load
+    d = jonswap_load.load("jonswap.bin")
+    plot(d["w"], d["S"]); plot(d["wc"], d["amps"], "+")
+"""
+
+import numpy as np
+
+PARAMS = ("alpha", "wp", "wmax", "gamma", "s1", "s2", "vel10", "F", "g", "depth")
+ARRAYS = ("w", "S", "edges", "wc", "amps", "paddleAmps")
+
+HEADER = np.dtype([("magic", "S8"), ("version", "<u4"), ("header_size", "<u4")]
+                  + [(p, "<f8") for p in PARAMS]
+                  + [("count", "<u8", (len(ARRAYS),))])
+
+
+def load(path="jonswap.bin"):
+    raw = np.memmap(path, dtype=np.uint8, mode="r")
+    h = raw[:HEADER.itemsize].view(HEADER)[0]
+    if not h["magic"].startswith(b"JONSWAP"):
+        raise ValueError("%s is not a jonswap file" % path)
+
+    d = {p: float(h[p]) for p in PARAMS}
+    d["version"] = int(h["version"])
+    offset = int(h["header_size"])
+    for name, n in zip(ARRAYS, h["count"]):
+        n = int(n)
+        d[name] = raw[offset:offset + 8 * n].view("<f8")
+        offset += 8 * n
+    return d